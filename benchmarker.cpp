@@ -1,26 +1,215 @@
 #include <iostream>         // For console output
-#include <list>             // NEW: For std::list
+#include <list>             // For std::list
 #include <vector>           // For dynamic arrays
+#include <string>           // For std::string, std::stoi
 #include <chrono>           // For high-resolution timing
 #include <fstream>          // For file output
 #include <iomanip>          // For output formatting
-#include <algorithm>        // NEW: For std::find
-#include <sys/resource.h>   // NEW: For memory usage monitoring (Linux/macOS)
+#include <algorithm>        // For std::find, std::sort
+#include <cmath>            // For std::sqrt
+#include <cstdio>           // For popen
+#include <ctime>            // For run timestamps
+#include <memory>           // For std::unique_ptr
+#include <unistd.h>         // For gethostname
+#include <sys/utsname.h>    // For the kernel release
 #include "hashset.hpp"      // Custom HashSet header
+#include "perf_counters.hpp" // Hardware counters (optional, Linux only)
+#include "workload.hpp"     // Key distributions and trace replay
 
-// NEW: Function to get memory usage in KB (Linux/macOS)
-size_t get_memory_usage() {
-    #ifdef __unix__
-        struct rusage usage;
-        getrusage(RUSAGE_SELF, &usage);
-        return usage.ru_maxrss;  // Returns KB on Linux, bytes on macOS
-    #else
-        // Simplified version for other platforms (returns 0)
-        return 0;
-    #endif
+// Keep a benchmarked result alive so the compiler can't drop the call that made it
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
 }
 
-// NEW: Benchmark class to compare HashSet and std::list
+// Live bytes and allocations made through CountingAllocator
+struct AllocationStats {
+    static size_t bytes;
+    static size_t allocations;
+};
+size_t AllocationStats::bytes = 0;
+size_t AllocationStats::allocations = 0;
+
+// Allocator that tracks the exact bytes and allocations of a std container
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        AllocationStats::bytes += n * sizeof(T);
+        AllocationStats::allocations += 1;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        AllocationStats::bytes -= n * sizeof(T);
+        AllocationStats::allocations -= 1;
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+using CountedList = std::list<int, CountingAllocator<int>>;
+
+// Summary of the per-operation samples of one benchmark case, in nanoseconds
+struct BenchStats {
+    double mean = 0;
+    double median = 0;
+    double p99 = 0;
+    double stddev = 0;
+    size_t samples = 0;
+};
+
+// Reduce a set of per-operation timings to summary statistics
+BenchStats summarize(std::vector<double> samples) {
+    BenchStats stats;
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0;
+    for (double s : samples) sum += s;
+    stats.mean = sum / samples.size();
+
+    double squares = 0;
+    for (double s : samples) squares += (s - stats.mean) * (s - stats.mean);
+    stats.stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0;
+
+    stats.median = samples[samples.size() / 2];
+    stats.p99 = samples[std::min(samples.size() - 1, (samples.size() * 99) / 100)];
+    stats.samples = samples.size();
+    return stats;
+}
+
+// Where and how a benchmark run was produced, recorded with every history row
+struct RunInfo {
+    std::string run_id;     // Timestamp, process id and commit, unique per run
+    std::string timestamp;  // UTC, ISO 8601
+    std::string commit;     // Short hash, "+dirty" if tracked files were modified
+    std::string compiler;
+    std::string flags;
+    std::string machine;    // Host, CPU model, hardware threads and kernel
+    std::string workload;   // What was measured: "fixed", describeWorkload() or "trace=<file>"
+};
+
+// First line of a shell command's output, or "" if it fails
+std::string commandOutput(const char* command) {
+    FILE* pipe = popen(command, "r");
+    if (pipe == nullptr) return "";
+    char line[256] = {0};
+    bool got = fgets(line, sizeof(line), pipe) != nullptr;
+    int status = pclose(pipe);
+    if (!got || status != 0) return "";
+    std::string out(line);
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r')) out.pop_back();
+    return out;
+}
+
+// Keep free text from breaking the CSV
+std::string csvField(std::string value) {
+    std::replace(value.begin(), value.end(), ',', ';');
+    std::replace(value.begin(), value.end(), '\n', ' ');
+    return value;
+}
+
+// Compile flags that change generated code. Build with
+// -DBENCH_CXXFLAGS='"$(CXXFLAGS)"' to record the exact command line.
+std::string compileFlags() {
+#ifdef BENCH_CXXFLAGS
+    return BENCH_CXXFLAGS;
+#else
+    std::string flags;
+#if defined(__OPTIMIZE_SIZE__)
+    flags += "-Os";
+#elif defined(__OPTIMIZE__)
+    flags += "-O2+";  // GCC and Clang don't distinguish -O2 from -O3 here
+#else
+    flags += "-O0";
+#endif
+#ifdef NDEBUG
+    flags += " -DNDEBUG";
+#endif
+#ifdef __AVX2__
+    flags += " avx2";
+#elif defined(__SSE4_2__)
+    flags += " sse4.2";
+#endif
+#ifdef __SSSE3__
+    flags += " ssse3";
+#endif
+    return flags;
+#endif
+}
+
+RunInfo currentRunInfo() {
+    RunInfo info;
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    info.timestamp = stamp;
+
+    info.commit = commandOutput("git rev-parse --short HEAD 2>/dev/null");
+    if (info.commit.empty()) info.commit = "unknown";
+    else if (!commandOutput("git status --porcelain --untracked-files=no 2>/dev/null").empty()) info.commit += "+dirty";
+
+    char id[64];
+    std::strftime(id, sizeof(id), "%Y%m%d-%H%M%S", std::gmtime(&now));
+    info.run_id = std::string(id) + "-" + std::to_string(getpid()) + "-" + info.commit;
+
+#if defined(__clang__)
+    info.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    info.compiler = "gcc " __VERSION__;
+#else
+    info.compiler = "unknown";
+#endif
+    info.flags = compileFlags();
+
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+    std::string cpu = "unknown cpu";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+            break;
+        }
+    }
+    struct utsname uts;
+    std::string kernel = uname(&uts) == 0 ? uts.release : "unknown";
+    info.machine = std::string(host) + " | " + cpu + " | " + std::to_string(sysconf(_SC_NPROCESSORS_ONLN)) +
+                   " threads | " + kernel;
+
+    info.compiler = csvField(info.compiler);
+    info.flags = csvField(info.flags);
+    info.machine = csvField(info.machine);
+    return info;
+}
+
+// Benchmark harness comparing HashSet and std::list.
+//
+// Each case is run WARMUP_RUNS times untimed and then `repetitions` times
+// timed. Within a timed run every operation pass (insert, contains, remove)
+// is split into BATCHES_PER_PASS batches and only the batch boundaries are
+// timed, so clock overhead is amortized over many operations. Every batch
+// contributes one ns/op sample to the statistics. Keys are plain ints
+// generated up front, so no parsing happens inside the timed region.
+//
+// Memory is measured exactly once per case, right after the first timed
+// insert pass: HashSet reports its own footprint and std::list goes through
+// CountingAllocator, so the numbers don't depend on ru_maxrss history.
+//
+// With --perf, hardware counters are read around each timed pass (not each
+// batch, to keep the syscalls out of the batches) and reported per operation.
 class HashSetBenchmark {
 private:
     // Load factor percentages to test
@@ -29,204 +218,365 @@ private:
     // Element counts for benchmarking
     const std::vector<int> element_counts = {1000, 10000, 100000, 1000000};
 
-    // NEW: Storage for benchmark timings
-    std::vector<std::vector<double>> custom_insert_times;
-    std::vector<std::vector<double>> stl_insert_times;
-    std::vector<std::vector<double>> custom_contains_times;
-    std::vector<std::vector<double>> stl_contains_times;
-    std::vector<std::vector<double>> custom_remove_times;
-    std::vector<std::vector<double>> stl_remove_times;
+    // Untimed runs before measuring, to fault in memory and warm caches
+    static const int WARMUP_RUNS = 2;
+    // Timed batches per operation pass
+    static const size_t BATCHES_PER_PASS = 64;
+    // std::list lookups and removals are O(n) each, so only this many keys
+    // (spread evenly over the list) are looked up or removed per pass
+    static const size_t LIST_SAMPLE_KEYS = 1000;
 
-    // NEW: Storage for memory usage data
-    std::vector<std::vector<size_t>> custom_memory_usage;
-    std::vector<std::vector<size_t>> stl_memory_usage;
+    int repetitions;
+    PerfCounters* perf;  // nullptr unless --perf was given and counters opened
 
-    // NEW: Helper: Convert integers to strings for HashSet insertion
-    std::vector<std::string> convertToStrings(const std::vector<int>& elements) {
-        std::vector<std::string> str_elements;
-        for (int val : elements) {
-            str_elements.push_back(std::to_string(val));
-        }
-        return str_elements;
-    }
+    // Everything recorded for one operation over all timed passes
+    struct PassTotals {
+        std::vector<double> samples;  // ns/op, one per batch
+        PerfSample counters;
+        size_t ops = 0;
+    };
 
-    // NEW: Measure time to insert elements into the custom HashSet
-    double benchmarkInsert(HashSet& set, const std::vector<std::string>& elements) {
-        auto start = std::chrono::high_resolution_clock::now();
-        for (const std::string& val : elements) {
-            set.insert(std::stoi(val));  // NEW: Explicit conversion
+    // One row of results
+    struct BenchResult {
+        std::string structure;
+        unsigned int load_factor;
+        int elements;
+        std::string operation;
+        BenchStats stats;
+        PerfSample counters;
+        size_t counted_ops;
+        size_t memory_bytes;   // Footprint with all elements inserted
+        size_t allocations;    // Live allocations with all elements inserted
+    };
+    std::vector<BenchResult> results;
+
+    // Time op over keys in BATCHES_PER_PASS batches. Results are recorded
+    // into totals unless it is nullptr (warmup).
+    template <typename Item, typename Op>
+    void timeBatches(const std::vector<Item>& keys, Op op, PassTotals* totals) {
+        size_t batch_size = std::max<size_t>(1, keys.size() / BATCHES_PER_PASS);
+        if (perf != nullptr) perf->start();
+        for (size_t begin = 0; begin < keys.size(); begin += batch_size) {
+            size_t end = std::min(keys.size(), begin + batch_size);
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = begin; i < end; ++i) {
+                op(keys[i]);
+            }
+            auto stop = std::chrono::steady_clock::now();
+            if (totals != nullptr) {
+                double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+                totals->samples.push_back(ns / (end - begin));
+            }
         }
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double>(end - start).count();
+        if (perf != nullptr) {
+            PerfSample sample = perf->stop();
+            if (totals != nullptr) totals->counters += sample;
+        }
+        if (totals != nullptr) totals->ops += keys.size();
     }
 
-    // NEW: Measure avg time to check if element exists in the custom HashSet
-    double benchmarkContains(HashSet& set, const std::vector<std::string>& elements) {
-        double totalTime = 0;
-        for (const std::string& val : elements) {
-            auto start = std::chrono::high_resolution_clock::now();
-            set.contains(std::stoi(val));  // NEW: Explicit conversion
-            auto end = std::chrono::high_resolution_clock::now();
-            totalTime += std::chrono::duration<double>(end - start).count();
-        }
-        return totalTime / elements.size();
+    void addResult(const std::string& structure, unsigned int load_factor, int elements,
+                   const std::string& operation, const PassTotals& totals,
+                   size_t memory_bytes, size_t allocations) {
+        results.push_back({structure, load_factor, elements, operation,
+                           summarize(totals.samples), totals.counters, totals.ops,
+                           memory_bytes, allocations});
     }
 
-    // NEW: Measure avg time to remove elements from the custom HashSet
-    double benchmarkRemove(HashSet& set, const std::vector<std::string>& elements) {
-        double totalTime = 0;
-        for (const std::string& val : elements) {
-            auto start = std::chrono::high_resolution_clock::now();
-            set.remove(std::stoi(val));  // NEW: Explicit conversion
-            auto end = std::chrono::high_resolution_clock::now();
-            totalTime += std::chrono::duration<double>(end - start).count();
+    // Pick up to LIST_SAMPLE_KEYS keys spread evenly over elements
+    static std::vector<int> sampleKeys(const std::vector<int>& elements) {
+        if (elements.size() <= LIST_SAMPLE_KEYS) return elements;
+        std::vector<int> sample;
+        size_t stride = elements.size() / LIST_SAMPLE_KEYS;
+        for (size_t i = 0; i < elements.size() && sample.size() < LIST_SAMPLE_KEYS; i += stride) {
+            sample.push_back(elements[i]);
         }
-        return totalTime / elements.size();
+        return sample;
     }
 
-    // NEW: Measure time to insert elements into std::list
-    double benchmarkInsertList(std::list<int>& list, const std::vector<int>& elements) {
-        auto start = std::chrono::high_resolution_clock::now();
-        for (int val : elements) {
-            list.push_back(val);
+    // Run the custom HashSet through insert/contains/remove passes
+    void benchmarkHashSet(unsigned int load_factor, const std::vector<int>& elements) {
+        PassTotals insert, contains, remove;
+        size_t memory_bytes = 0, allocations = 0;
+        for (int run = 0; run < WARMUP_RUNS + repetitions; ++run) {
+            bool timed = run >= WARMUP_RUNS;
+            HashSet set(std::max<size_t>(1, elements.size() / load_factor));
+            set.set_load_threshold(load_factor);
+
+            timeBatches(elements, [&](int key) { doNotOptimize(set.insert(key)); },
+                        timed ? &insert : nullptr);
+            if (run == WARMUP_RUNS) {
+                memory_bytes = set.memory_usage();
+                allocations = set.allocation_count();
+            }
+            timeBatches(elements, [&](int key) { doNotOptimize(set.contains(key)); },
+                        timed ? &contains : nullptr);
+            timeBatches(elements, [&](int key) { doNotOptimize(set.remove(key)); },
+                        timed ? &remove : nullptr);
         }
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double>(end - start).count();
+        int n = static_cast<int>(elements.size());
+        addResult("HashSet", load_factor, n, "Insert", insert, memory_bytes, allocations);
+        addResult("HashSet", load_factor, n, "Contains", contains, memory_bytes, allocations);
+        addResult("HashSet", load_factor, n, "Remove", remove, memory_bytes, allocations);
     }
 
-    // NEW: Measure avg time to find elements in std::list
-    double benchmarkContainsList(std::list<int>& list, const std::vector<int>& elements) {
-        double totalTime = 0;
-        for (int val : elements) {
-            auto start = std::chrono::high_resolution_clock::now();
-            std::find(list.begin(), list.end(), val);
-            auto end = std::chrono::high_resolution_clock::now();
-            totalTime += std::chrono::duration<double>(end - start).count();
+    // Run std::list through the same passes (lookups/removes on a key sample)
+    void benchmarkList(unsigned int load_factor, const std::vector<int>& elements) {
+        std::vector<int> sample = sampleKeys(elements);
+        PassTotals insert, contains, remove;
+        size_t memory_bytes = 0, allocations = 0;
+        for (int run = 0; run < WARMUP_RUNS + repetitions; ++run) {
+            bool timed = run >= WARMUP_RUNS;
+            size_t bytes_before = AllocationStats::bytes;
+            size_t allocations_before = AllocationStats::allocations;
+            CountedList list;
+
+            timeBatches(elements, [&](int key) { list.push_back(key); },
+                        timed ? &insert : nullptr);
+            if (run == WARMUP_RUNS) {
+                memory_bytes = AllocationStats::bytes - bytes_before;
+                allocations = AllocationStats::allocations - allocations_before;
+            }
+            timeBatches(sample, [&](int key) {
+                            doNotOptimize(std::find(list.begin(), list.end(), key) != list.end());
+                        }, timed ? &contains : nullptr);
+            timeBatches(sample, [&](int key) { list.remove(key); },
+                        timed ? &remove : nullptr);
+            doNotOptimize(list.size());
         }
-        return totalTime / elements.size();
+        int n = static_cast<int>(elements.size());
+        addResult("STL", load_factor, n, "Insert", insert, memory_bytes, allocations);
+        addResult("STL", load_factor, n, "Contains", contains, memory_bytes, allocations);
+        addResult("STL", load_factor, n, "Remove", remove, memory_bytes, allocations);
     }
 
-    // NEW: Measure avg time to remove elements from std::list
-    double benchmarkRemoveList(std::list<int>& list, const std::vector<int>& elements) {
-        double totalTime = 0;
-        for (int val : elements) {
-            auto start = std::chrono::high_resolution_clock::now();
-            list.remove(val);
-            auto end = std::chrono::high_resolution_clock::now();
-            totalTime += std::chrono::duration<double>(end - start).count();
+public:
+    // Replay a generated or recorded workload against HashSet. The preload
+    // keys are inserted untimed, then the mixed operation stream is timed.
+    void runWorkload(const std::string& label, const Workload& workload,
+                     unsigned int load_factor, size_t universe) {
+        results.clear();
+        std::cout << "Running workload " << label << ": " << workload.preload.size()
+                  << " preloaded keys, " << workload.ops.size() << " operations...\n";
+
+        PassTotals mixed;
+        size_t memory_bytes = 0, allocations = 0;
+        for (int run = 0; run < WARMUP_RUNS + repetitions; ++run) {
+            HashSet set(std::max<size_t>(1, universe / load_factor));
+            set.set_load_threshold(load_factor);
+            for (int key : workload.preload) set.insert(key);
+
+            timeBatches(workload.ops, [&](const WorkloadOp& op) {
+                            switch (op.type) {
+                                case OpType::Insert: doNotOptimize(set.insert(op.key)); break;
+                                case OpType::Lookup: doNotOptimize(set.contains(op.key)); break;
+                                case OpType::Remove: doNotOptimize(set.remove(op.key)); break;
+                            }
+                        }, run >= WARMUP_RUNS ? &mixed : nullptr);
+            if (run == WARMUP_RUNS) {
+                memory_bytes = set.memory_usage();
+                allocations = set.allocation_count();
+            }
         }
-        return totalTime / elements.size();
+        addResult("HashSet", load_factor, static_cast<int>(universe), label, mixed,
+                  memory_bytes, allocations);
     }
 
-public:
-    // NEW: Run all benchmarks and store results
-    void runBenchmarks() {
-        custom_insert_times.clear();
-        stl_insert_times.clear();
-        custom_contains_times.clear();
-        stl_contains_times.clear();
-        custom_remove_times.clear();
-        stl_remove_times.clear();
+    explicit HashSetBenchmark(int repetitions = 5, PerfCounters* perf = nullptr)
+        : repetitions(repetitions), perf(perf) {}
 
-        custom_memory_usage.clear();
-        stl_memory_usage.clear();
+    // Run all benchmarks and store results
+    void runBenchmarks() {
+        results.clear();
 
         for (unsigned int load_factor : load_factors) {
-            std::vector<double> custom_insert, stl_insert;
-            std::vector<double> custom_contains, stl_contains;
-            std::vector<double> custom_remove, stl_remove;
-            std::vector<size_t> custom_memory, stl_memory; // Memory measurement
-
             for (int num_elements : element_counts) {
                 std::cout << "Benchmarking with load factor " << load_factor
                           << "% and " << num_elements << " elements...\n";
 
                 // Generate test data
                 std::vector<int> elements;
+                elements.reserve(num_elements);
                 for (int i = 1; i <= num_elements; ++i) {
                     elements.push_back(i);
                 }
 
-                // NEW: Convert int elements to string elements
-                std::vector<std::string> stringElements = convertToStrings(elements);
-
-                // Benchmark custom hash set
-                HashSet custom_set(num_elements / load_factor);
-                custom_set.set_load_threshold(load_factor);
-
-                size_t custom_mem_before = get_memory_usage(); // Before insert
-                custom_insert.push_back(benchmarkInsert(custom_set, stringElements));  // Call to insert
-                size_t custom_mem_after = get_memory_usage();  // After insert
-                custom_memory.push_back(custom_mem_after - custom_mem_before); // Memory used
-
-                custom_contains.push_back(benchmarkContains(custom_set, stringElements));
-                custom_remove.push_back(benchmarkRemove(custom_set, stringElements));
-
-                // Benchmark STL list
-                std::list<int> stl_list;
-
-                size_t stl_mem_before = get_memory_usage();    // Before insert
-                stl_insert.push_back(benchmarkInsertList(stl_list, elements));  // Call to insert
-                size_t stl_mem_after = get_memory_usage();     // After insert
-                stl_memory.push_back(stl_mem_after - stl_mem_before);   // Memory used
-
-                stl_contains.push_back(benchmarkContainsList(stl_list, elements));
-                stl_remove.push_back(benchmarkRemoveList(stl_list, elements));
+                benchmarkHashSet(load_factor, elements);
+                benchmarkList(load_factor, elements);
             }
+        }
+    }
 
-            // Store results for this load factor
-            custom_insert_times.push_back(custom_insert);
-            stl_insert_times.push_back(stl_insert);
-            custom_contains_times.push_back(custom_contains);
-            stl_contains_times.push_back(stl_contains);
-            custom_remove_times.push_back(custom_remove);
-
-            custom_memory_usage.push_back(custom_memory); // Memory for custom
-            stl_memory_usage.push_back(stl_memory); // Memory for STL
+    // Print a table of the median and p99 per-operation times
+    void printSummary() const {
+        std::cout << std::left << std::setw(10) << "Structure" << std::setw(6) << "LF%"
+                  << std::setw(10) << "Elements" << std::setw(10) << "Operation"
+                  << std::right << std::setw(14) << "Median(ns)" << std::setw(14) << "P99(ns)"
+                  << std::setw(14) << "StdDev(ns)" << std::setw(12) << "Bytes/elem" << "\n";
+        for (const BenchResult& r : results) {
+            std::cout << std::left << std::setw(10) << r.structure << std::setw(6) << r.load_factor
+                      << std::setw(10) << r.elements << std::setw(10) << r.operation
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(14) << r.stats.median << std::setw(14) << r.stats.p99
+                      << std::setw(14) << r.stats.stddev
+                      << std::setw(12) << static_cast<double>(r.memory_bytes) / r.elements << "\n";
         }
+        std::cout.unsetf(std::ios::fixed);
     }
 
-    // NEW: Write benchmark results to CSV
-    void generateCSV() {
+    // Write benchmark results to CSV
+    void generateCSV() const {
         std::ofstream csv("performance_results.csv");
         if (!csv.is_open()) {
             std::cerr << "Error opening CSV file!\n";
             return;
         }
 
-        // CSV Header
-        csv << "DataStructure,LoadFactor,Elements,Operation,Time(ms)\n";
-
-        // Write data for each data structure, load factor, element count, and operation
-        for (size_t lf = 0; lf < load_factors.size(); ++lf) {
-            for (size_t i = 0; i < element_counts.size(); ++i) {
-                // Custom HashSet
-                csv << "HashSet," << load_factors[lf] << "," << element_counts[i] << ",Insert,"
-                    << custom_insert_times[lf][i] * 1000.0 << "\n"; // Convert to ms
-                csv << "HashSet," << load_factors[lf] << "," << element_counts[i] << ",Contains,"
-                    << custom_contains_times[lf][i] * 1000.0 << "\n"; // Convert to ms
-                csv << "HashSet," << load_factors[lf] << "," << element_counts[i] << ",Remove,"
-                    << custom_remove_times[lf][i] * 1000.0 << "\n"; // Convert to ms
-
-                // STL unordered_set
-                csv << "std::unordered_set," << load_factors[lf] << "," << element_counts[i] << ",Insert,"
-                    << stl_insert_times[lf][i] * 1000.0 << "\n"; // Convert to ms
-                csv << "std::unordered_set," << load_factors[lf] << "," << element_counts[i] << ",Contains,"
-                    << stl_contains_times[lf][i] * 1000.0 << "\n"; // Convert to ms
-                csv << "std::unordered_set," << load_factors[lf] << "," << element_counts[i] << ",Remove,"
-                    << stl_remove_times[lf][i] * 1000.0 << "\n"; // Convert to ms
+        // TimeMS is the median time per operation, kept for plot_charts.py.
+        // Memory columns describe the structure holding all elements.
+        // Counter columns are per operation and left empty without --perf.
+        csv << "DataStructure,LoadFactor,Operation,Elements,TimeMS,MeanNS,MedianNS,P99NS,StdDevNS,Samples,"
+            << "MemoryBytes,BytesPerElement,Allocations,"
+            << "CyclesPerOp,InstructionsPerOp,CacheMissesPerOp,BranchMissesPerOp,TLBMissesPerOp\n";
+        for (const BenchResult& r : results) {
+            csv << r.structure << "," << r.load_factor << "," << r.operation << "," << r.elements << ","
+                << r.stats.median / 1e6 << "," << r.stats.mean << "," << r.stats.median << ","
+                << r.stats.p99 << "," << r.stats.stddev << "," << r.stats.samples << ","
+                << r.memory_bytes << "," << static_cast<double>(r.memory_bytes) / r.elements << ","
+                << r.allocations;
+            if (perf != nullptr && r.counted_ops > 0) {
+                double ops = static_cast<double>(r.counted_ops);
+                csv << "," << r.counters.cycles / ops << "," << r.counters.instructions / ops
+                    << "," << r.counters.cache_misses / ops << "," << r.counters.branch_misses / ops
+                    << "," << r.counters.tlb_misses / ops << "\n";
+            } else {
+                csv << ",,,,,\n";
             }
         }
         csv.close();
         std::cout << "Benchmark data written to performance_results.csv\n";
     }
+
+    // Append this run's results to a history file that accumulates across
+    // runs; compare_benchmarks.py reads it to find regressions
+    void appendHistory(const std::string& path, const RunInfo& info) const {
+        bool exists = std::ifstream(path).good();
+        std::ofstream csv(path, std::ios::app);
+        if (!csv.is_open()) {
+            std::cerr << "Error opening history file: " << path << "\n";
+            return;
+        }
+        if (!exists) {
+            csv << "RunID,Timestamp,Commit,Compiler,Flags,Machine,"
+                << "DataStructure,LoadFactor,Operation,Elements,MeanNS,MedianNS,P99NS,StdDevNS,Samples,Workload\n";
+        }
+        for (const BenchResult& r : results) {
+            csv << info.run_id << "," << info.timestamp << "," << info.commit << "," << info.compiler << ","
+                << info.flags << "," << info.machine << "," << r.structure << "," << r.load_factor << ","
+                << r.operation << "," << r.elements << "," << r.stats.mean << "," << r.stats.median << ","
+                << r.stats.p99 << "," << r.stats.stddev << "," << r.stats.samples << "," << info.workload << "\n";
+        }
+        std::cout << "Appended run " << info.run_id << " to " << path << "\n";
+    }
 };
 
 // Main function to run the benchmarks
-int main() {
-    HashSetBenchmark benchmark;
-    benchmark.runBenchmarks();
+// Usage: benchmarker [--reps <n>] [--perf]
+//                    [--workload <sequential|uniform|zipf|collide|negative>]
+//                    [--mix <insert:lookup:remove>] [--keys <n>] [--ops <n>]
+//                    [--load-factor <percent>] [--seed <n>] [--trace <bytecode file>]
+//                    [--history <csv>] [--no-history]
+// Without --workload or --trace the fixed insert/contains/remove suite runs.
+// Every run is also appended to benchmark_history.csv unless --no-history.
+int main(int argc, char* argv[]) {
+    int repetitions = 5;
+    bool use_perf = false;
+    bool workload_mode = false;
+    std::string trace_file = "";
+    unsigned int load_factor = 70;
+    std::string history_file = "benchmark_history.csv";
+    WorkloadConfig config;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--perf") {
+                use_perf = true;
+                continue;
+            }
+            if (arg == "--no-history") {
+                history_file = "";
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--reps") {
+                repetitions = std::max(1, std::stoi(value));
+            } else if (arg == "--workload") {
+                config.distribution = value;
+                workload_mode = true;
+            } else if (arg == "--mix") {
+                parseMix(value, config);
+            } else if (arg == "--keys") {
+                config.keys = std::stoul(value);
+            } else if (arg == "--ops") {
+                config.ops = std::stoul(value);
+            } else if (arg == "--load-factor") {
+                load_factor = std::max(1, std::stoi(value));
+            } else if (arg == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (arg == "--trace") {
+                trace_file = value;
+            } else if (arg == "--history") {
+                history_file = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid arguments: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Only open the perf events when asked to; they cost file descriptors and PMU slots
+    std::unique_ptr<PerfCounters> counters;
+    if (use_perf) {
+        counters.reset(new PerfCounters());
+        if (!counters->available()) {
+            std::cerr << "Hardware counters unavailable (check perf_event_paranoid); "
+                      << "continuing without them" << std::endl;
+            counters.reset();
+        }
+    }
+
+    RunInfo run_info = currentRunInfo();
+    run_info.workload = "fixed";
+    HashSetBenchmark benchmark(repetitions, counters.get());
+    try {
+        if (!trace_file.empty()) {
+            Workload trace = loadTrace(trace_file);
+            run_info.workload = csvField("trace=" + trace_file);
+            benchmark.runWorkload("Trace", trace, load_factor, std::max<size_t>(1, trace.ops.size()));
+        } else if (workload_mode) {
+            if (config.distribution == "collide") {
+                config.collide_stride = collisionStride(config.keys, config.keys / load_factor);
+            }
+            run_info.workload = csvField(describeWorkload(config));
+            benchmark.runWorkload("Mixed-" + config.distribution, generateWorkload(config),
+                                  load_factor, config.keys);
+        } else {
+            benchmark.runBenchmarks();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
     benchmark.printSummary();
     benchmark.generateCSV();
+    if (!history_file.empty()) benchmark.appendHistory(history_file, run_info);
     return 0;
 }
@@ -7,8 +7,19 @@
 #include <string>
 #include <fstream>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <mutex>
+#include <sys/stat.h>
 #include "pack109.hpp"
 #include "program.hpp"
+#include "histogram.hpp"
+#include "logger.hpp"
+#include "socket_io.hpp"
+#include "myls.h"
 
 /**
  * Reads an entire file into a byte vector.
@@ -42,53 +53,355 @@ void write_file(const std::string& filename, const std::vector<unsigned char>& c
 }
 
 /**
- * Parses a hostname string with optional port (format: host:port).
- * 
- * @param hostname The hostname string to parse.
- * @return std::pair<std::string, int> The host and port as a pair.
+ * Settings for load-generation mode (--load).
  */
-std::pair<std::string, int> parse_hostname(const std::string& hostname) {
-    size_t colon_pos = hostname.find(':');
-    if (colon_pos == std::string::npos) return std::make_pair(hostname, 8081);
-    std::string host = hostname.substr(0, colon_pos);
-    int port = std::stoi(hostname.substr(colon_pos + 1));
-    return std::make_pair(host, port);
-}
+struct LoadConfig {
+    int concurrency = 4;          // Client threads, each with one request in flight
+    double rate = 0;              // Total requests per second; 0 runs closed-loop
+    unsigned int read_pct = 90;   // Share of requests that are REQUESTs; the rest send files
+    std::string size_dist = "fixed:1024";  // fixed:N, uniform:MIN:MAX or exp:MEAN bytes
+    double duration = 10.0;       // Seconds of measured load
+    int files = 100;              // Distinct files seeded on the server and read back
+};
 
 /**
- * Sends all data in the buffer, looping as needed.
- * 
- * @param sockfd The socket file descriptor.
- * @param data Pointer to the data buffer.
- * @param length Number of bytes to send.
- * @return true if all data is sent, false otherwise.
+ * Draws file sizes from a "fixed:N", "uniform:MIN:MAX" or "exp:MEAN" spec,
+ * clamped to the 65535-byte protocol limit.
  */
-bool send_all(int sockfd, const unsigned char* data, size_t length) {
-    size_t total_sent = 0;
-    while (total_sent < length) {
-        ssize_t sent = send(sockfd, data + total_sent, length - total_sent, 0);
-        if (sent <= 0) return false;
-        total_sent += sent;
+class SizeDistribution {
+private:
+    std::string kind;
+    double a, b;
+
+public:
+    explicit SizeDistribution(const std::string& spec) : a(0), b(0) {
+        size_t colon = spec.find(':');
+        kind = spec.substr(0, colon);
+        std::string rest = colon == std::string::npos ? "" : spec.substr(colon + 1);
+        size_t second = rest.find(':');
+        if (kind == "fixed" && !rest.empty()) a = std::stod(rest);
+        else if (kind == "exp" && !rest.empty()) a = std::stod(rest);
+        else if (kind == "uniform" && second != std::string::npos) {
+            a = std::stod(rest.substr(0, second));
+            b = std::stod(rest.substr(second + 1));
+        } else {
+            throw std::invalid_argument("Size distribution must be fixed:N, uniform:MIN:MAX or exp:MEAN");
+        }
+        if (a < 0 || b < 0 || (kind == "uniform" && b < a)) throw std::invalid_argument("Invalid size range");
     }
+
+    template <typename Rng>
+    size_t operator()(Rng& rng) const {
+        double size = a;
+        if (kind == "uniform") size = std::uniform_real_distribution<double>(a, b + 1)(rng);
+        else if (kind == "exp") size = a > 0 ? std::exponential_distribution<double>(1.0 / a)(rng) : 0;
+        return static_cast<size_t>(std::min(size, 65535.0));
+    }
+};
+
+/**
+ * Sends one length-prefixed, encrypted message on a connected socket and
+ * reads the reply.
+ *
+ * @param fd The connected socket.
+ * @param message The encrypted message.
+ * @param reply Buffer receiving the decrypted reply; reused across calls.
+ * @return true if the exchange completed and the reply is not an error STATUS.
+ */
+bool exchange_on(int fd, const std::vector<unsigned char>& message, std::vector<unsigned char>& reply) {
+    uint32_t len = htonl(message.size());
+    bool ok = send_all(fd, reinterpret_cast<unsigned char*>(&len), sizeof(len));
+    ok = ok && send_all(fd, message.data(), message.size());
+    ok = ok && recv_all(fd, reinterpret_cast<unsigned char*>(&len), sizeof(len));
+    if (ok) {
+        len = ntohl(len);
+        ok = len > 0 && len <= 70000;
+        if (ok) {
+            reply.resize(len);
+            ok = recv_all(fd, reply.data(), len);
+        }
+    }
+    if (!ok) return false;
+    xor_crypt(reply, XOR_KEY);
+    if (reply[0] == STATUS_MESSAGE) return deserialize_status(reply).code == STATUS_OK;
     return true;
 }
 
 /**
- * Receives all data into buffer, looping as needed.
- * 
- * @param sockfd The socket file descriptor.
- * @param data Pointer to the buffer to fill.
- * @param length Number of bytes to receive.
- * @return true if all data is received, false otherwise.
+ * Sends one message on a fresh connection and reads the reply, as the server
+ * handles one message per connection.
+ *
+ * @param addr The server address.
+ * @param message The encrypted message.
+ * @param reply Buffer receiving the decrypted reply; reused across calls.
+ * @return true if the exchange completed and the reply is not an error STATUS.
+ */
+bool exchange(const sockaddr_in& addr, const std::vector<unsigned char>& message, std::vector<unsigned char>& reply) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    bool ok = connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0 &&
+              exchange_on(fd, message, reply);
+    close(fd);
+    return ok;
+}
+
+/**
+ * Builds an encrypted FILE message of the given size.
+ */
+std::vector<unsigned char> make_file_message(const std::string& name, size_t size, std::mt19937_64& rng) {
+    File file;
+    file.filename = name;
+    file.data.resize(size);
+    for (unsigned char& byte : file.data) byte = static_cast<unsigned char>(rng());
+    std::vector<unsigned char> message = serialize_file_raw(file);
+    xor_crypt(message, XOR_KEY);
+    return message;
+}
+
+/**
+ * Runs the load generator and prints throughput, errors and the latency
+ * distribution.
+ *
+ * Every request carries its own connection. Messages are built before the
+ * clock starts so only network and server time is measured. In open-loop
+ * mode (rate > 0) each thread issues requests on a fixed schedule and
+ * latency is measured from the scheduled start, so a stalled server shows
+ * up as queueing delay instead of silently lowering the offered load
+ * (coordinated omission).
+ *
+ * @return int Exit status code.
  */
-bool recv_all(int sockfd, unsigned char* data, size_t length) {
-    size_t total_received = 0;
-    while (total_received < length) {
-        ssize_t received = recv(sockfd, data + total_received, length - total_received, 0);
-        if (received <= 0) return false;
-        total_received += received;
+int run_load(const sockaddr_in& addr, const LoadConfig& config) {
+    SizeDistribution sizes(config.size_dist);
+    std::mt19937_64 seed_rng(1);
+
+    // Seed the files that reads will request
+    std::vector<unsigned char> reply;
+    std::vector<std::vector<unsigned char>> read_messages;
+    for (int i = 0; i < config.files; i++) {
+        std::string name = "load_" + std::to_string(i);
+        if (!exchange(addr, make_file_message(name, sizes(seed_rng), seed_rng), reply)) {
+            LOG_ERROR("Failed to seed %s on the server", name.c_str());
+            return 1;
+        }
+        read_messages.push_back(serialize_request_raw(Request(name)));
+        xor_crypt(read_messages.back(), XOR_KEY);
     }
-    return true;
+
+    // Writes cycle through a pool per thread, overwriting the seeded files
+    const size_t WRITE_POOL = 32;
+    std::vector<std::vector<std::vector<unsigned char>>> write_messages(config.concurrency);
+    if (config.read_pct < 100) {
+        for (int t = 0; t < config.concurrency; t++) {
+            for (size_t i = 0; i < WRITE_POOL; i++) {
+                std::string name = "load_" + std::to_string(seed_rng() % config.files);
+                write_messages[t].push_back(make_file_message(name, sizes(seed_rng), seed_rng));
+            }
+        }
+    }
+
+    std::vector<LatencyHistogram> histograms(config.concurrency);
+    std::vector<uint64_t> completed(config.concurrency, 0), errors(config.concurrency, 0);
+    std::atomic<bool> go(false);
+    auto start = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(config.duration));
+    // Each thread offers rate / concurrency, staggered so arrivals interleave
+    std::chrono::steady_clock::duration interval(0);
+    if (config.rate > 0) {
+        interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(config.concurrency / config.rate));
+    }
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < config.concurrency; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937_64 rng(1000 + t);
+            std::uniform_int_distribution<unsigned int> percent(0, 99);
+            std::vector<unsigned char> buffer;
+            buffer.reserve(70000);
+            size_t next_write = 0;
+            auto scheduled = start + interval * t / config.concurrency;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            for (uint64_t n = 0;; n++) {
+                if (config.rate > 0) {
+                    scheduled = start + interval * t / config.concurrency + interval * n;
+                    if (scheduled >= deadline) break;
+                    std::this_thread::sleep_until(scheduled);
+                } else {
+                    scheduled = std::chrono::steady_clock::now();
+                    if (scheduled >= deadline) break;
+                }
+                bool ok;
+                // A malformed reply throws from deserialize_status; count it instead of ending the run
+                try {
+                    if (percent(rng) < config.read_pct) {
+                        ok = exchange(addr, read_messages[rng() % read_messages.size()], buffer);
+                    } else {
+                        ok = exchange(addr, write_messages[t][next_write++ % WRITE_POOL], buffer);
+                    }
+                } catch (const std::exception&) {
+                    ok = false;
+                }
+                auto end = std::chrono::steady_clock::now();
+                if (ok) {
+                    histograms[t].record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - scheduled).count());
+                    completed[t]++;
+                } else {
+                    errors[t]++;
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_until(start);
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LatencyHistogram latency;
+    uint64_t total = 0, failed = 0;
+    for (int t = 0; t < config.concurrency; t++) {
+        latency.merge(histograms[t]);
+        total += completed[t];
+        failed += errors[t];
+    }
+
+    std::cout << "Mode: " << (config.rate > 0 ? "open-loop" : "closed-loop")
+              << ", concurrency " << config.concurrency << ", " << config.read_pct << "% reads, sizes "
+              << config.size_dist << "\n";
+    std::cout << "Requests: " << total << " ok, " << failed << " errors in " << elapsed << " s\n";
+    std::cout << "Throughput: " << (elapsed > 0 ? total / elapsed : 0) << " req/s\n";
+    std::cout << "Latency (us): mean " << latency.mean() / 1000.0 << ", max " << latency.max() / 1000.0 << "\n";
+    const double percentiles[] = {50, 75, 90, 95, 99, 99.9, 99.99};
+    std::cout << "  Percentile   Latency(us)\n";
+    for (double p : percentiles) {
+        std::cout << "  " << p << "%\t" << latency.percentile(p) / 1000.0 << "\n";
+    }
+    return failed > 0 ? 2 : 0;
+}
+
+/**
+ * State shared by the walker threads during --ingest.
+ *
+ * Files are read on the walker threads; appending to the batch and sending
+ * it happen under the mutex, so the connection carries one batch at a time.
+ */
+struct IngestState {
+    int fd = -1;
+    size_t batch_bytes = 1 << 20;      // Send once the batch would grow past this
+    std::mutex mutex;
+    std::vector<unsigned char> batch;  // Plain BATCH message under construction
+    std::vector<unsigned char> reply;
+    size_t files = 0;
+    size_t bytes = 0;
+    size_t batches = 0;
+    std::atomic<size_t> skipped{0};
+    std::atomic<bool> failed{false};
+};
+
+/**
+ * Encrypts and sends the pending batch, then waits for the server's STATUS.
+ * Called with state.mutex held.
+ *
+ * @return true if the server stored the batch.
+ */
+bool flush_batch(IngestState& state) {
+    if (state.batch.empty()) return true;
+    xor_crypt(state.batch, XOR_KEY);
+    bool ok;
+    // This runs on the C walker's threads, so nothing may propagate out of it
+    try {
+        ok = exchange_on(state.fd, state.batch, state.reply);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Bad reply to batch %zu: %s", state.batches + 1, e.what());
+        ok = false;
+    }
+    state.batch.clear();  // Keeps its capacity for the next batch
+    state.batches++;
+    if (!ok) {
+        LOG_ERROR("Server rejected batch %zu", state.batches);
+        state.failed = true;
+    }
+    return ok;
+}
+
+/**
+ * WalkVisitor file callback: reads one regular file and adds it to the batch.
+ * Errors set state.failed instead of throwing, since the caller is C.
+ */
+void ingest_file(const char* directory, const char* name, const struct stat* st, void* context) {
+    IngestState& state = *static_cast<IngestState*>(context);
+    if (state.failed || !S_ISREG(st->st_mode)) return;
+    File file;
+    file.filename = std::string(directory) + "/" + name;
+    if (st->st_size > 65535) {
+        LOG_WARN("Skipping %s: %lld bytes (max 65535)", file.filename.c_str(), static_cast<long long>(st->st_size));
+        state.skipped++;
+        return;
+    }
+    try {
+        file.data = read_file(file.filename);
+    } catch (const std::exception& e) {
+        LOG_WARN("Skipping %s: %s", file.filename.c_str(), e.what());
+        state.skipped++;
+        return;
+    }
+    size_t record = 6 + file.filename.size() + file.data.size();
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.batch.empty() && state.batch.size() + record > state.batch_bytes) {
+        if (!flush_batch(state)) return;
+    }
+    try {
+        append_batch_file_raw(file, state.batch);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Could not add %s to the batch: %s", file.filename.c_str(), e.what());
+        state.failed = true;
+        return;
+    }
+    state.files++;
+    state.bytes += file.data.size();
+}
+
+/**
+ * WalkVisitor directory callback: reports directories that couldn't be read.
+ */
+void ingest_directory_done(const DirSummary* summary, void*) {
+    if (summary->error) LOG_WARN("Skipping directory %s: %s", summary->path, strerror(summary->error));
+}
+
+/**
+ * Walks a directory tree and stores every regular file on the server over one
+ * connection, in BATCH messages of about batch_bytes each. The server persists
+ * once, when the connection closes.
+ *
+ * @return int Exit status code.
+ */
+int run_ingest(const sockaddr_in& addr, const std::string& root, int threads, size_t batch_bytes) {
+    IngestState state;
+    state.batch_bytes = batch_bytes;
+    state.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (state.fd < 0 || connect(state.fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        LOG_ERROR("Connection failed");
+        if (state.fd >= 0) close(state.fd);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WalkVisitor visitor = {ingest_directory_done, ingest_file, &state};
+    walk_directory(root.c_str(), 1, threads, &visitor);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.failed) flush_batch(state);
+    }
+    close(state.fd);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LOG_INFO("Ingested %zu files (%zu bytes) in %zu batches in %.2f s (%.0f files/s), %zu skipped",
+             state.files, state.bytes, state.batches, elapsed, elapsed > 0 ? state.files / elapsed : 0.0,
+             state.skipped.load());
+    return state.failed ? 1 : 0;
 }
 
 /**
@@ -101,6 +414,18 @@ bool recv_all(int sockfd, unsigned char* data, size_t length) {
  *   --hostname <host[:port]>  Specify the server host and optional port (default: localhost:8081)
  *   --send <filename>         Send a file to the server
  *   --request <filename>      Request a file from the server
+ *   --stats                   Print the server's metrics
+ *   --load                    Generate load instead of a single transfer, with:
+ *     --concurrency <n>       Client threads (default: 4)
+ *     --rate <req/s>          Total offered rate; omit for closed-loop
+ *     --read-ratio <pct>      Percentage of requests that read (default: 90)
+ *     --size <dist>           fixed:N, uniform:MIN:MAX or exp:MEAN (default: fixed:1024)
+ *     --duration <seconds>    Length of the run (default: 10)
+ *     --files <n>             Files seeded on the server for reads (default: 100)
+ *   --ingest <directory>      Store every regular file under directory (as directory/...)
+ *                             over one connection in BATCH messages, with:
+ *     --concurrency <n>       Threads walking and reading files (default: 4)
+ *     --batch-bytes <n>       Target BATCH size (default: 1048576, max 4194304)
  * 
  * @return int Exit status code.
  */
@@ -109,6 +434,11 @@ int main(int argc, char *argv[]) {
     int port = 8081;
     std::string send_file = "";
     std::string request_file = "";
+    bool load_mode = false;
+    bool stats = false;
+    std::string ingest_dir = "";
+    size_t batch_bytes = 1 << 20;
+    LoadConfig load;
 
     // Parse args
     for (int i = 1; i < argc; i++) {
@@ -125,99 +455,148 @@ int main(int argc, char *argv[]) {
         } else if (arg == "--request") {
             if (i + 1 < argc) request_file = argv[++i];
             else { std::cerr << "Missing value for --request\n"; return 1; }
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--load") {
+            load_mode = true;
+        } else if (arg == "--ingest") {
+            if (i + 1 < argc) ingest_dir = argv[++i];
+            else { std::cerr << "Missing value for --ingest\n"; return 1; }
+        } else if (arg == "--batch-bytes") {
+            if (i + 1 >= argc) { std::cerr << "Missing value for --batch-bytes\n"; return 1; }
+            try {
+                batch_bytes = std::stoul(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid value for --batch-bytes: " << e.what() << "\n"; return 1;
+            }
+            if (batch_bytes == 0 || batch_bytes > MAX_BATCH_MESSAGE_SIZE) {
+                std::cerr << "--batch-bytes must be between 1 and " << MAX_BATCH_MESSAGE_SIZE << "\n"; return 1;
+            }
+        } else if (arg == "--concurrency" || arg == "--rate" || arg == "--read-ratio" || arg == "--size" ||
+                   arg == "--duration" || arg == "--files") {
+            if (i + 1 >= argc) { std::cerr << "Missing value for " << arg << "\n"; return 1; }
+            std::string value = argv[++i];
+            try {
+                if (arg == "--concurrency") load.concurrency = std::max(1, std::stoi(value));
+                else if (arg == "--rate") load.rate = std::stod(value);
+                else if (arg == "--read-ratio") load.read_pct = std::min(100, std::max(0, std::stoi(value)));
+                else if (arg == "--size") { SizeDistribution check(value); load.size_dist = value; }
+                else if (arg == "--duration") load.duration = std::stod(value);
+                else load.files = std::max(1, std::stoi(value));
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid value for " << arg << ": " << e.what() << "\n"; return 1;
+            }
         }
     }
-    if (send_file.empty() && request_file.empty()) {
-        std::cerr << "Error: Either --send or --request must be specified\n";
+    if (!load_mode && !stats && send_file.empty() && request_file.empty() && ingest_dir.empty()) {
+        std::cerr << "Error: One of --send, --request, --stats, --load or --ingest must be specified\n";
         return 1;
     }
 
-    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (client_fd < 0) { std::cerr << "Error creating socket\n"; return 1; }
-
     struct sockaddr_in server_addr;
     server_addr.sin_family = AF_INET;
     server_addr.sin_port = htons(port);
     if (inet_pton(AF_INET, hostname.c_str(), &server_addr.sin_addr) <= 0) {
         if (hostname == "localhost") server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-        else { std::cerr << "Invalid address: " << hostname << '\n'; close(client_fd); return 1; }
+        else { std::cerr << "Invalid address: " << hostname << '\n'; return 1; }
+    }
+
+    if (load_mode) {
+        try {
+            return run_load(server_addr, load);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
     }
 
+    if (!ingest_dir.empty()) {
+        return run_ingest(server_addr, ingest_dir, load.concurrency, batch_bytes);
+    }
+
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (client_fd < 0) { LOG_ERROR("Error creating socket"); return 1; }
+
     if (connect(client_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        std::cerr << "Connection failed to " << hostname << ":" << port << '\n';
+        LOG_ERROR("Connection failed to %s:%d", hostname.c_str(), port);
         close(client_fd); return 1;
     }
-    std::cout << "Connected to server at " << hostname << ":" << port << std::endl;
+    if (!stats) LOG_INFO("Connected to server at %s:%d", hostname.c_str(), port);
 
     try {
         std::vector<unsigned char> message;
-        if (!send_file.empty()) {
+        if (stats) {
+            message.push_back(STATS_MESSAGE);
+            xor_crypt(message, XOR_KEY);
+        } else if (!send_file.empty()) {
             std::vector<unsigned char> file_content = read_file(send_file);
 
             // === CHANGE: File size check added ===
             if (file_content.size() > 65535) {
-                std::cerr << "File too large: " << file_content.size() << " bytes (max 65535)\n";
+                LOG_ERROR("File too large: %zu bytes (max 65535)", file_content.size());
                 close(client_fd); return 1;
             }
 
             File file;
             file.filename = send_file;
             file.data = file_content;
-            message = serialize_file(file);
+            message = serialize_file_raw(file);
             xor_crypt(message, XOR_KEY);
-            std::cout << "Sending file: " << send_file << " (" << file_content.size() << " bytes)" << std::endl;
-            std::cout << "Serialized message size: " << message.size() << " bytes" << std::endl;
+            LOG_INFO("Sending file: %s (%zu bytes)", send_file.c_str(), file_content.size());
+            LOG_INFO("Serialized message size: %zu bytes", message.size());
         } else {
             Request request;
             request.filename = request_file;
-            message = serialize_request(request);
+            message = serialize_request_raw(request);
             xor_crypt(message, XOR_KEY);
-            std::cout << "Requesting file: " << request_file << std::endl;
+            LOG_INFO("Requesting file: %s", request_file.c_str());
         }
 
         // Length prefix (4 bytes, network byte order)
         uint32_t msg_len = htonl(message.size());
         if (!send_all(client_fd, reinterpret_cast<unsigned char*>(&msg_len), sizeof(msg_len))) {
-            std::cerr << "Error sending message length\n"; close(client_fd); return 1;
+            LOG_ERROR("Error sending message length"); close(client_fd); return 1;
         }
         if (!send_all(client_fd, message.data(), message.size())) {
-            std::cerr << "Error sending message to server\n"; close(client_fd); return 1;
+            LOG_ERROR("Error sending message to server"); close(client_fd); return 1;
         }
 
         // Receive length prefix
         uint32_t resp_len = 0;
         if (!recv_all(client_fd, reinterpret_cast<unsigned char*>(&resp_len), sizeof(resp_len))) {
-            std::cerr << "Error reading response length from server\n"; close(client_fd); return 1;
+            LOG_ERROR("Error reading response length from server"); close(client_fd); return 1;
         }
         resp_len = ntohl(resp_len);
 
         // === CHANGE: Updated response size check for clarity ===
         if (resp_len > 70000) {  // Updated to match server limit (could also use 65535)
-            std::cerr << "Response too large: " << resp_len << " bytes\n"; close(client_fd); return 1;
+            LOG_ERROR("Response too large: %u bytes", resp_len); close(client_fd); return 1;
         }
 
         std::vector<unsigned char> buffer(resp_len);
         if (!recv_all(client_fd, buffer.data(), resp_len)) {
-            std::cerr << "Error reading response from server\n"; close(client_fd); return 1;
+            LOG_ERROR("Error reading response from server"); close(client_fd); return 1;
         }
         xor_crypt(buffer, XOR_KEY);
 
-        if (buffer[0] == FILE_MESSAGE) {
-            File received_file = deserialize_file(buffer);
+        if (buffer[0] == FILE_MESSAGE || buffer[0] == FILE_RAW_MESSAGE) {
+            File received_file = buffer[0] == FILE_RAW_MESSAGE ? deserialize_file_raw(buffer) : deserialize_file(buffer);
             write_file(received_file.filename, received_file.data);
-            std::cout << "Received file: " << received_file.filename 
-                      << " (" << received_file.data.size() << " bytes)\nFile saved successfully\n";
+            LOG_INFO("Received file: %s (%zu bytes)", received_file.filename.c_str(), received_file.data.size());
+            LOG_INFO("File saved successfully");
         } else if (buffer[0] == STATUS_MESSAGE) {
             Status status = deserialize_status(buffer);
-            if (status.code == STATUS_OK)
-                std::cout << "Server response: SUCCESS - " << status.message << std::endl;
+            if (stats && status.code == STATUS_OK)
+                std::cout << status.message;
+            else if (status.code == STATUS_OK)
+                LOG_INFO("Server response: SUCCESS - %s", status.message.c_str());
             else
-                std::cerr << "Server response: ERROR - " << status.message << std::endl;
+                LOG_ERROR("Server response: ERROR - %s", status.message.c_str());
         } else {
-            std::cerr << "Unknown response type from server" << std::endl;
+            LOG_ERROR("Unknown response type from server");
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: %s", e.what());
     }
     close(client_fd);
     return 0;
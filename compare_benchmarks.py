@@ -0,0 +1,158 @@
+import argparse  # Import argparse for the command line interface
+import csv  # Import csv to read the history file without extra dependencies
+import math  # Import math for the t-distribution
+import sys  # Import sys for the exit status
+
+# Compare two runs recorded in benchmark_history.csv (written by benchmarker)
+# and flag statistically significant slowdowns.
+#
+# Usage: python3 compare_benchmarks.py [BASE] [NEW] [--history FILE]
+#                                      [--alpha 0.01] [--threshold 5]
+# BASE and NEW are run IDs or commit prefixes. By default NEW is the last run
+# in the file and BASE the latest earlier run of the same workload (the
+# Workload column: the fixed suite, a --workload with its mix, keys, ops and
+# seed, or a --trace file). Cases match only within the same workload. A case
+# is a regression when its mean time grew by more than --threshold percent and
+# Welch's t-test rejects "same mean" at level --alpha. The exit status is 1 if
+# any case regressed and 2 if the runs had no case in common, so the script
+# can gate a commit or a CI job.
+
+
+def log_beta(a, b):
+    return math.lgamma(a) + math.lgamma(b) - math.lgamma(a + b)
+
+
+def beta_fraction(a, b, x):
+    # Continued fraction for the incomplete beta function (Lentz's method)
+    tiny = 1e-300
+    c, d = 1.0, 1.0 - (a + b) * x / (a + 1.0)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 300):
+        for numerator in (m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                          -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            h *= d * c
+        if abs(d * c - 1.0) < 1e-12:
+            break
+    return h
+
+
+def incomplete_beta(a, b, x):
+    # Regularized incomplete beta I_x(a, b)
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(a * math.log(x) + b * math.log(1.0 - x) - log_beta(a, b))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * beta_fraction(a, b, x) / a
+    return 1.0 - front * beta_fraction(b, a, 1.0 - x) / b
+
+
+def welch_t_test(mean1, sd1, n1, mean2, sd2, n2):
+    # Two-sided p-value for equal means with unequal variances
+    v1, v2 = sd1 * sd1 / n1, sd2 * sd2 / n2
+    if v1 + v2 == 0.0:
+        return 0.0 if mean1 != mean2 else 1.0
+    t = (mean2 - mean1) / math.sqrt(v1 + v2)
+    df = (v1 + v2) ** 2 / (v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1))
+    return incomplete_beta(df / 2.0, 0.5, df / (df + t * t))
+
+
+def load_runs(path):
+    # Rows grouped by RunID, in file order
+    runs = {}
+    with open(path, newline='') as f:
+        # Files started before the Workload column existed have it only past
+        # the header; rows from before it have none
+        for row in csv.DictReader(f, restkey='Workload'):
+            workload = row.get('Workload')
+            row['Workload'] = (workload[0] if isinstance(workload, list) else workload) or ''
+            runs.setdefault(row['RunID'], []).append(row)
+    return runs
+
+
+def pick_run(runs, key):
+    matches = [run_id for run_id, rows in runs.items()
+               if run_id == key or rows[0]['Commit'].startswith(key)]
+    if not matches:
+        sys.exit("No run matches '%s'" % key)
+    return matches[-1]  # Latest run for a commit
+
+
+def case_key(row):
+    return (row['DataStructure'], row['LoadFactor'], row['Operation'], row['Elements'], row['Workload'])
+
+
+def previous_run(runs, order, new_id):
+    # Latest run before new_id with the same workload
+    workload = runs[new_id][0]['Workload']
+    earlier = order[:order.index(new_id)]
+    for run_id in reversed(earlier):
+        if runs[run_id][0]['Workload'] == workload:
+            return run_id
+    print("No earlier run with workload '%s' to compare %s against" % (workload or 'unknown', new_id))
+    sys.exit(2)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag benchmark regressions between two runs")
+    parser.add_argument('base', nargs='?', help="Baseline run ID or commit (default: previous run of the same workload)")
+    parser.add_argument('new', nargs='?', help="New run ID or commit (default: last run)")
+    parser.add_argument('--history', default='benchmark_history.csv')
+    parser.add_argument('--alpha', type=float, default=0.01, help="Significance level")
+    parser.add_argument('--threshold', type=float, default=5.0, help="Minimum slowdown in percent")
+    args = parser.parse_args()
+
+    runs = load_runs(args.history)
+    order = list(runs)
+    if len(order) < 2 and not (args.base and args.new):
+        sys.exit("Need at least two runs in %s" % args.history)
+    new_id = pick_run(runs, args.new) if args.new else order[-1]
+    base_id = pick_run(runs, args.base) if args.base else previous_run(runs, order, new_id)
+    base_rows, new_rows = runs[base_id], runs[new_id]
+
+    print("Base: %s (%s)" % (base_id, base_rows[0]['Workload'] or 'unknown workload'))
+    print("New:  %s (%s)" % (new_id, new_rows[0]['Workload'] or 'unknown workload'))
+    # Numbers from different machines or builds aren't comparable
+    for field in ('Machine', 'Compiler', 'Flags'):
+        if base_rows[0][field] != new_rows[0][field]:
+            print("Warning: %s differs (%s vs %s)" % (field, base_rows[0][field], new_rows[0][field]))
+
+    base_cases = {case_key(row): row for row in base_rows}
+    regressions = 0
+    compared = 0
+    print("%-44s %12s %12s %8s %10s" % ("Case", "Base ns", "New ns", "Change", "p-value"))
+    for row in new_rows:
+        base = base_cases.get(case_key(row))
+        if base is None:
+            continue
+        m1, s1, n1 = float(base['MeanNS']), float(base['StdDevNS']), int(base['Samples'])
+        m2, s2, n2 = float(row['MeanNS']), float(row['StdDevNS']), int(row['Samples'])
+        if n1 < 2 or n2 < 2 or m1 <= 0.0:
+            continue
+        compared += 1
+        change = (m2 - m1) / m1 * 100.0
+        p = welch_t_test(m1, s1, n1, m2, s2, n2)
+        flag = ""
+        if p < args.alpha and change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif p < args.alpha and change < -args.threshold:
+            flag = "  improved"
+        name = "%s lf=%s %s n=%s" % case_key(row)[:4]
+        print("%-44s %12.2f %12.2f %+7.1f%% %10.2g%s" % (name, m1, m2, change, p, flag))
+
+    if compared == 0:
+        print("No cases in common: the runs measured different workloads or too few samples")
+        return 2
+    print("%d case(s) compared, %d regression(s)" % (compared, regressions))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
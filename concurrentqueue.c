@@ -0,0 +1,129 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "concurrentqueue.h"
+
+#define QUEUE_CACHE_LINE 64
+
+// A slot in the ring. sequence == position means it's free for the producer
+// claiming that position; sequence == position + 1 means it holds an item for
+// the consumer claiming that position.
+typedef struct {
+    atomic_size_t sequence;
+    void* item;
+} Cell;
+
+// The two positions live on separate cache lines so producers and consumers
+// don't invalidate each other's line on every operation
+struct ConcurrentQueue {
+    _Alignas(QUEUE_CACHE_LINE) atomic_size_t tail;  // Next position to insert at
+    _Alignas(QUEUE_CACHE_LINE) atomic_size_t head;  // Next position to remove from
+    _Alignas(QUEUE_CACHE_LINE) Cell* cells;
+    size_t mask;                                     // Capacity - 1
+};
+
+// Create an empty queue holding up to capacity items (rounded up to a power of two)
+ConcurrentQueue* createConcurrentQueue(int capacity) {
+    if (capacity < 1) {
+        return NULL;
+    }
+    size_t slots = 1;
+    while (slots < (size_t)capacity) {
+        slots <<= 1;
+    }
+    //sizeof(ConcurrentQueue) is a multiple of its alignment, as aligned_alloc requires
+    ConcurrentQueue* queue = (ConcurrentQueue*)aligned_alloc(QUEUE_CACHE_LINE, sizeof(ConcurrentQueue));
+    if (!queue) {
+        return NULL;
+    }
+    queue->cells = (Cell*)malloc(slots * sizeof(Cell));
+    if (!queue->cells) {
+        free(queue);
+        return NULL;
+    }
+    for (size_t i = 0; i < slots; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+        queue->cells[i].item = NULL;
+    }
+    queue->mask = slots - 1;
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    return queue;
+}
+
+// Insert item at the end of the queue. Returns 1 if the queue is full.
+int concurrentInsertAtTail(ConcurrentQueue* queue, void* item) {
+    size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    for (;;) {
+        Cell* cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+        if (diff == 0) {
+            //slot is free: claim the position; on failure position is reloaded
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->item = item;
+                //publish the item to the consumer that claims this position
+                atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+                return 0;
+            }
+        } else if (diff < 0) {
+            //slot still holds the item from one lap ago: full
+            return 1;
+        } else {
+            //another producer got here first
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+}
+
+// Remove the item at the start of the queue into *item. Returns 1 if the queue is empty.
+int concurrentRemoveHead(ConcurrentQueue* queue, void** item) {
+    size_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    for (;;) {
+        Cell* cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(position + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *item = cell->item;
+                //hand the slot back to producers for the next lap
+                atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+                return 0;
+            }
+        } else if (diff < 0) {
+            //no item published at this position yet: empty
+            return 1;
+        } else {
+            //another consumer got here first
+            position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+}
+
+// Number of queued items. Only a snapshot while other threads are active.
+int concurrentSize(ConcurrentQueue* queue) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    //the two loads aren't atomic together, so clamp what a race can produce
+    if (tail <= head) {
+        return 0;
+    }
+    size_t count = tail - head;
+    return (int)(count > queue->mask + 1 ? queue->mask + 1 : count);
+}
+
+// Maximum number of items the queue can hold
+int concurrentCapacity(ConcurrentQueue* queue) {
+    return (int)(queue->mask + 1);
+}
+
+// Free the queue. No other thread may be using it.
+void freeConcurrentQueue(ConcurrentQueue* queue) {
+    if (queue == NULL) {
+        return;
+    }
+    free(queue->cells);
+    free(queue);
+}
@@ -0,0 +1,43 @@
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bounded multi-producer/multi-consumer queue with the same tail-insert,
+// head-remove semantics as List in linkedlist.h, safe to call from any number
+// of threads without a lock. It is a ring of cells that each carry a sequence
+// number (Vyukov's bounded MPMC queue): a producer or consumer claims a slot
+// with one compare-and-swap on the shared tail or head position, and the
+// sequence number tells it whether the slot is ready. Operations never block;
+// a full or empty queue is reported to the caller.
+//
+// The struct is opaque so C++ code can use it without C11 <stdatomic.h>.
+typedef struct ConcurrentQueue ConcurrentQueue;
+
+// Create an empty queue holding up to capacity items (rounded up to a power
+// of two). Returns NULL if capacity < 1 or memory runs out.
+ConcurrentQueue* createConcurrentQueue(int capacity);
+
+// Insert item at the end of the queue. Returns 1 if the queue is full.
+int concurrentInsertAtTail(ConcurrentQueue* queue, void* item);
+
+// Remove the item at the start of the queue into *item. Returns 1 if the
+// queue is empty; NULL is a valid item, so emptiness isn't signalled by it.
+int concurrentRemoveHead(ConcurrentQueue* queue, void** item);
+
+// Number of queued items. Only a snapshot while other threads are active.
+int concurrentSize(ConcurrentQueue* queue);
+
+// Maximum number of items the queue can hold
+int concurrentCapacity(ConcurrentQueue* queue);
+
+// Free the queue. No other thread may be using it.
+void freeConcurrentQueue(ConcurrentQueue* queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
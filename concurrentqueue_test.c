@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>      //sched_yield while the queue is full or empty
+#include <stdatomic.h>
+#include "concurrentqueue.h"
+
+//Tests for concurrentqueue.c: single-threaded edge cases, then a stress run
+//where PRODUCERS threads push distinct items through a small queue to
+//CONSUMERS threads. Every item must come out exactly once, the popped and
+//pushed sums must match, and each consumer must see any one producer's items
+//in the order they were pushed.
+//
+//Build: gcc -std=gnu11 -Wall -pthread concurrentqueue_test.c concurrentqueue.c -o concurrentqueue_test
+//Usage: concurrentqueue_test   (add -fsanitize=thread to the build to check for races too)
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 100000
+#define STRESS_CAPACITY 64  //small, so the ring wraps often and producers see it full
+#define TOTAL_ITEMS ((long)PRODUCERS * ITEMS_PER_PRODUCER)
+
+static ConcurrentQueue* queue;
+static atomic_uchar seen[TOTAL_ITEMS];  //times each item was popped
+static atomic_long popped;              //items popped by all consumers
+static atomic_int duplicates;
+static atomic_int outOfOrder;
+
+typedef struct {
+    int id;
+    long sum;  //of the items this thread pushed or popped
+} Worker;
+
+static void check(const char* label, bool passed) {
+    printf("%s: ", label);
+    if (passed) {
+        printf("Passed\n");
+    } else {
+        printf("Failed\n");
+        exit(1);
+    }
+}
+
+//Item number for producer p's i-th push; item 0 is NULL, which is a valid item
+static void* itemFor(int producer, long i) {
+    return (void*)(intptr_t)(producer * (long)ITEMS_PER_PRODUCER + i);
+}
+
+static void* produce(void* arg) {
+    Worker* worker = (Worker*)arg;
+    for (long i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        void* item = itemFor(worker->id, i);
+        while (concurrentInsertAtTail(queue, item) != 0) {
+            sched_yield(); //full: let a consumer run
+        }
+        worker->sum += (long)(intptr_t)item;
+    }
+    return NULL;
+}
+
+static void* consume(void* arg) {
+    Worker* worker = (Worker*)arg;
+    long last[PRODUCERS];  //last item seen from each producer
+    for (int p = 0; p < PRODUCERS; p++) {
+        last[p] = -1;
+    }
+    while (atomic_load(&popped) < TOTAL_ITEMS) {
+        void* item;
+        if (concurrentRemoveHead(queue, &item) != 0) {
+            sched_yield(); //empty: let a producer run
+            continue;
+        }
+        long value = (long)(intptr_t)item;
+        if (value < 0 || value >= TOTAL_ITEMS || atomic_fetch_add(&seen[value], 1) != 0) {
+            atomic_fetch_add(&duplicates, 1);
+        } else {
+            int producer = (int)(value / ITEMS_PER_PRODUCER);
+            if (value <= last[producer]) {
+                atomic_fetch_add(&outOfOrder, 1);
+            }
+            last[producer] = value;
+        }
+        worker->sum += value;
+        atomic_fetch_add(&popped, 1);
+    }
+    return NULL;
+}
+
+int main(void) {
+    //capacity rounds up to a power of two and bad capacities are refused
+    ConcurrentQueue* small = createConcurrentQueue(5);
+    check("Test 1 - capacity rounds up", small != NULL && concurrentCapacity(small) == 8 && createConcurrentQueue(0) == NULL);
+
+    //full and empty are reported, and NULL survives a round trip
+    bool ok = true;
+    for (long i = 0; i < 8; i++) {
+        ok = ok && concurrentInsertAtTail(small, (void*)(intptr_t)i) == 0;
+    }
+    ok = ok && concurrentInsertAtTail(small, (void*)(intptr_t)8) == 1 && concurrentSize(small) == 8;
+    for (long i = 0; i < 8; i++) {
+        void* item = (void*)(intptr_t)-1;
+        ok = ok && concurrentRemoveHead(small, &item) == 0 && item == (void*)(intptr_t)i;
+    }
+    void* item;
+    ok = ok && concurrentRemoveHead(small, &item) == 1 && concurrentSize(small) == 0;
+    check("Test 2 - FIFO order, full and empty", ok);
+    freeConcurrentQueue(small);
+
+    queue = createConcurrentQueue(STRESS_CAPACITY);
+    Worker producers[PRODUCERS], consumers[CONSUMERS];
+    pthread_t threads[PRODUCERS + CONSUMERS];
+    for (int i = 0; i < CONSUMERS; i++) {
+        consumers[i] = (Worker){i, 0};
+        pthread_create(&threads[PRODUCERS + i], NULL, consume, &consumers[i]);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        producers[i] = (Worker){i, 0};
+        pthread_create(&threads[i], NULL, produce, &producers[i]);
+    }
+    for (int i = 0; i < PRODUCERS + CONSUMERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    long pushedSum = 0, poppedSum = 0;
+    for (int i = 0; i < PRODUCERS; i++) {
+        pushedSum += producers[i].sum;
+    }
+    for (int i = 0; i < CONSUMERS; i++) {
+        poppedSum += consumers[i].sum;
+    }
+    long missing = 0;
+    for (long i = 0; i < TOTAL_ITEMS; i++) {
+        missing += atomic_load(&seen[i]) == 0;
+    }
+    printf("%d producers x %d consumers, %ld items: pushed sum %ld, popped sum %ld\n",
+           PRODUCERS, CONSUMERS, TOTAL_ITEMS, pushedSum, poppedSum);
+    check("Test 3 - popped sum equals pushed sum", pushedSum == poppedSum && pushedSum == TOTAL_ITEMS * (TOTAL_ITEMS - 1) / 2);
+    check("Test 4 - every item popped exactly once",
+          missing == 0 && atomic_load(&duplicates) == 0 && atomic_load(&popped) == TOTAL_ITEMS);
+    check("Test 5 - each producer's items stay in order", atomic_load(&outOfOrder) == 0);
+    check("Test 6 - queue empty afterwards", concurrentSize(queue) == 0 && concurrentRemoveHead(queue, &item) == 1);
+    freeConcurrentQueue(queue);
+    return 0;
+}
@@ -25,6 +25,13 @@ private:
     size_t size;
     size_t capacity;
     
+    // Heap bytes owned by a string; short strings live inside the object (SSO)
+    static size_t heapBytes(const std::string& s) {
+        const char* begin = reinterpret_cast<const char*>(&s);
+        bool inline_buffer = s.data() >= begin && s.data() < begin + sizeof(s);
+        return inline_buffer ? 0 : s.capacity() + 1;
+    }
+    
     // Hash function
     size_t hash(const std::string& key) const {
         // Simple hash function
@@ -87,6 +94,22 @@ public:
         throw std::out_of_range("Key not found in hash map: " + key);
     }
     
+    // Get a pointer to the value for a key, without copying it
+    // Returns nullptr if the key doesn't exist
+    const File* find(const std::string& key) const {
+        size_t index = hash(key);
+        
+        Node* current = buckets[index];
+        while (current != nullptr) {
+            if (current->key == key) {
+                return &current->value;
+            }
+            current = current->next;
+        }
+        
+        return nullptr;
+    }
+    
     // Check if a key exists
     bool contains(const std::string& key) const {
         size_t index = hash(key);
@@ -184,6 +207,35 @@ public:
     size_t getCapacity() const {
         return capacity;
     }
+    
+    // Return the exact bytes held by the map: bucket array, nodes, key and
+    // filename strings that spilled to the heap, and file payloads
+    size_t memory_usage() const {
+        size_t bytes = buckets.capacity() * sizeof(Node*);
+        for (size_t i = 0; i < capacity; i++) {
+            for (Node* current = buckets[i]; current != nullptr; current = current->next) {
+                bytes += sizeof(Node);
+                bytes += heapBytes(current->key);
+                bytes += heapBytes(current->value.filename);
+                bytes += current->value.data.capacity();
+            }
+        }
+        return bytes;
+    }
+    
+    // Return the number of live heap allocations behind memory_usage()
+    size_t allocation_count() const {
+        size_t count = buckets.capacity() > 0 ? 1 : 0;
+        for (size_t i = 0; i < capacity; i++) {
+            for (Node* current = buckets[i]; current != nullptr; current = current->next) {
+                count += 1;
+                count += heapBytes(current->key) > 0 ? 1 : 0;
+                count += heapBytes(current->value.filename) > 0 ? 1 : 0;
+                count += current->value.data.capacity() > 0 ? 1 : 0;
+            }
+        }
+        return count;
+    }
 };
 
 #endif // HASHMAP_HPP
\ No newline at end of file
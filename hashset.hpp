@@ -33,4 +33,7 @@ public:
     unsigned int load() const;      // Return the current load factor as a percentage
     void set_load_threshold(unsigned int threshold);  // Set a new load factor threshold for resizing
     void clear();                   // Remove all elements from the hash set
+
+    size_t memory_usage() const;      // Exact bytes held by the bucket array and nodes
+    size_t allocation_count() const;  // Live heap allocations (bucket array + one per node)
 };
@@ -0,0 +1,103 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Log-linear latency histogram in the style of HdrHistogram.
+//
+// Values (normally nanoseconds) are grouped by power of two, and every power
+// of two is split into SUB_BUCKETS linear sub-buckets, so any recorded value
+// is reported within 1/SUB_BUCKETS (about 6%) of its true value while the
+// whole 64-bit range fits in a fixed array. Recording is one shift and one
+// increment, cheap enough to do per request.
+
+namespace histogram {
+
+    const int SUB_BUCKET_BITS = 4;
+    const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    // Index of the bucket holding value
+    inline int bucketIndex(uint64_t value) {
+        if (value < static_cast<uint64_t>(SUB_BUCKETS)) return static_cast<int>(value);
+        int exponent = 63 - __builtin_clzll(value);
+        int shift = exponent - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    // Largest value that falls into bucket index
+    inline uint64_t bucketValue(int index) {
+        if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+        uint64_t low = (static_cast<uint64_t>(SUB_BUCKETS) + sub) << shift;
+        return low + ((static_cast<uint64_t>(1) << shift) - 1);
+    }
+
+}
+
+class LatencyHistogram {
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t sum;
+    uint64_t max_value;
+
+public:
+    LatencyHistogram() : counts(histogram::BUCKET_COUNT, 0), total(0), sum(0), max_value(0) {}
+
+    void record(uint64_t value) {
+        counts[histogram::bucketIndex(value)]++;
+        total++;
+        sum += value;
+        if (value > max_value) max_value = value;
+    }
+
+    // Add another histogram's samples into this one
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < histogram::BUCKET_COUNT; i++) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        if (other.max_value > max_value) max_value = other.max_value;
+    }
+
+    // Add one bucket's worth of samples, for histograms kept elsewhere
+    void addBucket(int index, uint64_t count, uint64_t value_sum) {
+        counts[index] += count;
+        total += count;
+        sum += value_sum;
+        if (count > 0 && histogram::bucketValue(index) > max_value) max_value = histogram::bucketValue(index);
+    }
+
+    void clear() {
+        for (uint64_t& c : counts) c = 0;
+        total = sum = max_value = 0;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total == 0 ? 0.0 : static_cast<double>(sum) / total; }
+
+    // Value at percentile p (0-100), accurate to the bucket width
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total);
+        if (rank >= total) rank = total - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < histogram::BUCKET_COUNT; i++) {
+            seen += counts[i];
+            if (seen > rank) {
+                uint64_t value = histogram::bucketValue(i);
+                return value < max_value ? value : max_value;
+            }
+        }
+        return max_value;
+    }
+
+    // Count in bucket index, for printing the distribution
+    uint64_t bucketCount(int index) const { return counts[index]; }
+};
+
+#endif // HISTOGRAM_HPP
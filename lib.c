@@ -8,6 +8,169 @@
 void initList(List* list_pointer) { //parameter needed to be used to set the list that are in head and tail as NULL
     list_pointer->head = NULL;
     list_pointer->tail = NULL;
+    list_pointer->length = 0;
+    list_pointer->skip = NULL; //skip index starts disabled
+    list_pointer->skipStride = 0;
+    list_pointer->skipCount = 0;
+    list_pointer->skipCapacity = 0;
+    list_pointer->pool = NULL; //nodes come from malloc until useNodePool
+    list_pointer->hash = NULL; //hash index starts disabled
+    list_pointer->compare = NULL;
+    list_pointer->hashEntries = NULL;
+    list_pointer->hashCapacity = 0;
+}
+
+// A change at position invalidates every skip entry at or after it; entries
+// before it still point at the same positions
+static void invalidateSkip(List* list_pointer, int position) {
+    if (list_pointer->skipStride == 0) {
+        return;
+    }
+    int stillValid = (position + list_pointer->skipStride - 1) / list_pointer->skipStride;
+    if (stillValid < list_pointer->skipCount) {
+        list_pointer->skipCount = stillValid;
+    }
+}
+
+// Return the node at index (0 <= index < length). With the skip index this
+// walks at most skipStride - 1 nodes after extending the index as needed.
+static Node* nodeAt(List* list_pointer, int index) {
+    if (index == list_pointer->length - 1) {
+        return list_pointer->tail;
+    }
+    int stride = list_pointer->skipStride;
+    if (stride == 0) {
+        Node* current = list_pointer->head;
+        for (int i = 0; i < index; i++) {
+            current = current->next;
+        }
+        return current;
+    }
+    int entry = index / stride;
+    if (entry >= list_pointer->skipCount) {
+        //extend the index from the last valid entry up to the one we need
+        if (entry >= list_pointer->skipCapacity) {
+            int capacity = list_pointer->skipCapacity ? list_pointer->skipCapacity : 16;
+            while (capacity <= entry) {
+                capacity *= 2;
+            }
+            Node** grown = (Node**)realloc(list_pointer->skip, capacity * sizeof(Node*));
+            if (!grown) { //out of memory: fall back to a walk from the head
+                Node* current = list_pointer->head;
+                for (int i = 0; i < index; i++) {
+                    current = current->next;
+                }
+                return current;
+            }
+            list_pointer->skip = grown;
+            list_pointer->skipCapacity = capacity;
+        }
+        int k = list_pointer->skipCount;
+        Node* current = k == 0 ? list_pointer->head : list_pointer->skip[k - 1];
+        if (k == 0) {
+            list_pointer->skip[k++] = current;
+        }
+        for (; k <= entry; k++) {
+            for (int i = 0; i < stride; i++) {
+                current = current->next;
+            }
+            list_pointer->skip[k] = current;
+        }
+        list_pointer->skipCount = entry + 1;
+    }
+    Node* current = list_pointer->skip[entry];
+    for (int i = entry * stride; i < index; i++) {
+        current = current->next;
+    }
+    return current;
+}
+
+// Keep a pointer to every stride-th node so indexed operations walk at most
+// stride nodes instead of up to the whole list. A stride of 0 turns it off.
+int enableSkipIndex(List* list_pointer, int stride) {
+    if (list_pointer == NULL || stride < 0) {
+        return 1;
+    }
+    free(list_pointer->skip);
+    list_pointer->skip = NULL;
+    list_pointer->skipStride = stride;
+    list_pointer->skipCount = 0; //built lazily on the next indexed operation
+    list_pointer->skipCapacity = 0;
+    return 0;
+}
+
+// Turn the hash index off after a failed allocation; lookups fall back to scanning
+static void dropHashIndex(List* list_pointer) {
+    free(list_pointer->hashEntries);
+    list_pointer->hashEntries = NULL;
+    list_pointer->hashCapacity = 0;
+    list_pointer->hash = NULL;
+}
+
+// Put node into entries without checking for room
+static void hashPlace(HashEntry* entries, int capacity, Node* node, size_t hash) {
+    size_t mask = (size_t)capacity - 1;
+    size_t slot = hash & mask;
+    while (entries[slot].node != NULL) {
+        slot = (slot + 1) & mask;
+    }
+    entries[slot].node = node;
+    entries[slot].hash = hash;
+}
+
+// Record a node just linked into the list; grows the table to stay at most half full
+static void hashAdd(List* list_pointer, Node* node) {
+    if (list_pointer->hash == NULL) {
+        return;
+    }
+    //length already counts node
+    if (list_pointer->length * 2 > list_pointer->hashCapacity) {
+        int capacity = list_pointer->hashCapacity ? list_pointer->hashCapacity * 2 : 16;
+        HashEntry* entries = (HashEntry*)calloc(capacity, sizeof(HashEntry));
+        if (!entries) {
+            dropHashIndex(list_pointer);
+            return;
+        }
+        for (int i = 0; i < list_pointer->hashCapacity; i++) {
+            if (list_pointer->hashEntries[i].node != NULL) {
+                hashPlace(entries, capacity, list_pointer->hashEntries[i].node, list_pointer->hashEntries[i].hash);
+            }
+        }
+        free(list_pointer->hashEntries);
+        list_pointer->hashEntries = entries;
+        list_pointer->hashCapacity = capacity;
+    }
+    hashPlace(list_pointer->hashEntries, list_pointer->hashCapacity, node, list_pointer->hash(node->item));
+}
+
+// Forget a node about to be unlinked. Entries are matched by node, not key,
+// so duplicates are told apart without calling compare.
+static void hashRemove(List* list_pointer, Node* node) {
+    if (list_pointer->hash == NULL) {
+        return;
+    }
+    HashEntry* entries = list_pointer->hashEntries;
+    size_t mask = (size_t)list_pointer->hashCapacity - 1;
+    size_t slot = list_pointer->hash(node->item) & mask;
+    while (entries[slot].node != node) {
+        slot = (slot + 1) & mask;
+    }
+    //backward-shift deletion: pull later entries of the probe run into the gap so no tombstones are needed
+    size_t next = slot;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (entries[next].node == NULL) {
+            break;
+        }
+        size_t home = entries[next].hash & mask;
+        //move the entry unless its home lies cyclically in (slot, next]
+        bool stays = slot <= next ? (home > slot && home <= next) : (home > slot || home <= next);
+        if (!stays) {
+            entries[slot] = entries[next];
+            slot = next;
+        }
+    }
+    entries[slot].node = NULL;
 }
 
 // Create node containing item, return reference of it.
@@ -22,10 +185,78 @@ Node* createNode(void* item) {
     return newNode;
 }
 
+// Initialize an empty node pool
+void initNodePool(NodePool* pool) {
+    pool->slabs = NULL;
+    pool->freeNodes = NULL;
+    pool->slabUsed = NODE_POOL_SLAB_NODES; //forces a slab allocation on first use
+    pool->inUse = 0;
+}
+
+// Free every slab at once, without visiting individual nodes
+void destroyNodePool(NodePool* pool) {
+    NodeSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        NodeSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    initNodePool(pool);
+}
+
+// Take nodes for this list from pool
+int useNodePool(List* list_pointer, NodePool* pool) {
+    if (list_pointer == NULL || list_pointer->head != NULL) {
+        return 1; //existing nodes came from elsewhere and can't be mixed in
+    }
+    list_pointer->pool = pool;
+    return 0;
+}
+
+// Create a node for this list: from its pool if it has one, else createNode()
+static Node* allocNode(List* list_pointer, void* item) {
+    NodePool* pool = list_pointer->pool;
+    if (pool == NULL) {
+        return createNode(item);
+    }
+    Node* newNode = pool->freeNodes;
+    if (newNode != NULL) {
+        pool->freeNodes = newNode->next; //reuse the most recently freed node, likely still cached
+    } else {
+        if (pool->slabUsed == NODE_POOL_SLAB_NODES) {
+            NodeSlab* slab = (NodeSlab*)malloc(sizeof(NodeSlab));
+            if (!slab) {
+                return NULL;
+            }
+            slab->next = pool->slabs;
+            pool->slabs = slab;
+            pool->slabUsed = 0;
+        }
+        newNode = &pool->slabs->nodes[pool->slabUsed++];
+    }
+    pool->inUse++;
+    newNode->item = item;
+    newNode->next = NULL;
+    return newNode;
+}
+
+// Give a node back to wherever allocNode got it (and drop it from the hash index)
+static void releaseNode(List* list_pointer, Node* node) {
+    hashRemove(list_pointer, node);
+    NodePool* pool = list_pointer->pool;
+    if (pool == NULL) {
+        free(node);
+        return;
+    }
+    node->next = pool->freeNodes;
+    pool->freeNodes = node;
+    pool->inUse--;
+}
+
 // Insert new item at the end of list.
 int insertAtTail(List* list_pointer, void* item) {
     //same code as insertAtHead() with few minor details
-    Node* newNode = createNode(item);
+    Node* newNode = allocNode(list_pointer, item);
     if (!newNode) {
         return 1;
     }
@@ -38,6 +269,8 @@ int insertAtTail(List* list_pointer, void* item) {
         list_pointer->tail->next = newNode;
         list_pointer->tail = newNode;
     }
+    list_pointer->length++; //appending never invalidates the skip index
+    hashAdd(list_pointer, newNode);
     return 0;
 }
 
@@ -50,7 +283,7 @@ int insertAtHead(List* list_pointer, void* item) {
     //code above does not work through debugging due to list_pointer does not correctly access the head of the list
     //Must make sure if createNode returns NULL and handles error
     //need to be able to return 0 or 1 as success or failure
-    Node* newNode = createNode(item);
+    Node* newNode = allocNode(list_pointer, item);
     if (newNode == NULL) {
         return 1;
     }
@@ -61,38 +294,34 @@ int insertAtHead(List* list_pointer, void* item) {
     if (list_pointer->tail == NULL) {
         list_pointer->tail = newNode;
     }
+    list_pointer->length++;
+    invalidateSkip(list_pointer, 0); //every position shifted by one
+    hashAdd(list_pointer, newNode);
     return 0;
 }
 
 // Insert item at a specified index.
 int insertAtIndex(List* list_pointer, int index, void* item) {
-    if (list_pointer == NULL || index < 0) {
-        return 1;
-    }
-    Node* newNode = createNode(item);
-    if (newNode == NULL) {
-        return 1; // Memory allocation failure
+    if (list_pointer == NULL || index < 0 || index > list_pointer->length) {
+        return 1; // Index out of bounds, checked against the cached length
     }
     if (index == 0) {
         return insertAtHead(list_pointer, item); //this is similar to when starting off the list with empty--adding the nodes will start from the head
     }
-    Node* current = list_pointer->head;
-    for (int i = 0; i < index - 1 && current != NULL; i++) {
-        current = current->next;
+    if (index == list_pointer->length) {
+        return insertAtTail(list_pointer, item);
     }
-
-    if (current == NULL) {
-        free(newNode); // Index out of bounds, free the allocated node
-        return 1;       // Indicate failure
+    Node* newNode = allocNode(list_pointer, item);
+    if (newNode == NULL) {
+        return 1; // Memory allocation failure
     }
+    Node* current = nodeAt(list_pointer, index - 1); //node before the insertion point
 
     newNode->next = current->next;
     current->next = newNode;
-
-    if (newNode->next == NULL) {
-        list_pointer->tail = newNode;
-    }
-    //If the new node is at the end of the list, we update the tail pointer.
+    list_pointer->length++;
+    invalidateSkip(list_pointer, index);
+    hashAdd(list_pointer, newNode);
     return 0;
 }
 
@@ -103,19 +332,20 @@ void* removeTail(List* list_pointer) {
     }
     if (list_pointer->head == list_pointer->tail) { //If head and tail are the same (only one node):Frees the node and sets both head and tail to NULL.
         void* item = (void*)list_pointer->tail->item; //Stores the item from the tail node to return later
-        free(list_pointer->head);
+        releaseNode(list_pointer, list_pointer->head);
         list_pointer->head = NULL;
         list_pointer->tail = NULL;
+        list_pointer->length = 0;
+        invalidateSkip(list_pointer, 0);
         return item;
-    } //Traverses the list to find the second-to-last node. Frees the tail node. Updates the second-to-last node to be the new tail.
-    Node* current = list_pointer->head;
-    while (current->next && current->next != list_pointer->tail) { //it originally crashed, must add current->next twice since it might have been seen as NULL
-        current = current->next;
-    }
+    } //Finds the second-to-last node (through the skip index if enabled). Frees the tail node. Updates the second-to-last node to be the new tail.
+    Node* current = nodeAt(list_pointer, list_pointer->length - 2);
     void* item = (void*)list_pointer->tail->item;
-    free(list_pointer->tail);
+    releaseNode(list_pointer, list_pointer->tail);
     list_pointer->tail = current;
     current->next = NULL;
+    list_pointer->length--;
+    invalidateSkip(list_pointer, list_pointer->length); //only an entry for the old tail can be stale
     return item; //returns stored item
 }
 
@@ -127,10 +357,12 @@ void* removeHead(List* list_pointer) { //sample sources simply placed head = hea
     void* item = (void*)list_pointer->head->item; //same way it is stored as tail with the item to be returned later
     Node* prevHead = list_pointer->head; //Saves the current head node to free it later.
     list_pointer->head = list_pointer->head->next; //Updates the head to point to the next node.
-    free(prevHead); //Frees the old head node.
+    releaseNode(list_pointer, prevHead); //Frees the old head node.
     if (list_pointer->head == NULL) { //If the list is now empty (head is NULL), sets tail to NULL as well.
         list_pointer->tail = NULL;
     }
+    list_pointer->length--;
+    invalidateSkip(list_pointer, 0);
     return item; //returns stored item
 }
 
@@ -146,23 +378,14 @@ void* removeAtIndex(List* list_pointer, int index) {
         return removeHead(list_pointer);  // Special case: removing the head of the list
     }
 
-    /* Traverse the list to find the node before the one to be removed.
-       The loop runs until it reaches the node just before the specified index.
-       If the index is out of bounds (i.e., current->next becomes NULL before reaching index - 1),
-       the function returns NULL. */
-    Node* current = list_pointer->head;
-    for (int i = 0; i < index - 1; i++) {
-        if (current->next == NULL) {  // Check if we've reached the end of the list prematurely
-            return NULL;  // Index is out of bounds, return NULL
-        }
-        current = current->next;  // Move to the next node in the list
-    }
-
-    // After traversing, check if current->next is NULL, which means index is out of bounds
-    if (current->next == NULL) {
+    // The cached length makes the bounds check O(1)
+    if (index >= list_pointer->length) {
         return NULL;  // Index is invalid, return NULL
     }
 
+    /* Find the node before the one to be removed, through the skip index if it is enabled. */
+    Node* current = nodeAt(list_pointer, index - 1);
+
     /* At this point, current points to the node just before the one to be removed.
        Save a pointer to the node that needs to be removed. */
     Node* nodeToRemove = current->next;
@@ -181,7 +404,9 @@ void* removeAtIndex(List* list_pointer, int index) {
     }
 
     // Free the memory allocated for 'nodeToRemove'
-    free(nodeToRemove);
+    releaseNode(list_pointer, nodeToRemove);
+    list_pointer->length--;
+    invalidateSkip(list_pointer, index);
 
     // Return the item stored in the removed node
     return item;
@@ -189,20 +414,11 @@ void* removeAtIndex(List* list_pointer, int index) {
 
 // Return item at index
 void* itemAtIndex(List* list_pointer, int index) {
-    if (list_pointer == NULL || index < 0) { //This checks if the list pointer is NULL (invalid list) or if the index is negative.
+    if (list_pointer == NULL || index < 0 || index >= list_pointer->length) { //This checks if the list pointer is NULL (invalid list) or if the index is out of bounds.
         return NULL;
     }
 
-    Node* current = list_pointer->head; //creates a current and sets it to the head of the list.
-    for (int i = 0; i < index && current != NULL; i++) { //loops through the list until we've moved index number of times and we reach the end of the list where current becomes NULL
-        current = current->next;
-    }
-
-    if (current != NULL) { //if current not NULL, found node at the index adn return that item
-        return current->item;
-    } else {
-        return NULL;
-    }
+    return nodeAt(list_pointer, index)->item; //walks from the head, or from the nearest skip entry if enabled
 }
 
 // Return true if the list contains the given item at least once, false otherwise.
@@ -222,23 +438,235 @@ bool contains(List* list_pointer, void* item) {
     return false; //gone through the list with no match
 }
 
-// Returns the size of the list, measured in nodes.
-int size(List* list_pointer) {
-    int count = 0;
-    if (list_pointer == NULL) { //checks for empty list 
+// Return true if some item compares equal to key, using compare(item, key)
+bool containsBy(List* list_pointer, const void* key, ItemCompare compare) {
+    if (list_pointer == NULL || compare == NULL) {
+        return false;
+    }
+    for (Node* current = list_pointer->head; current != NULL; current = current->next) {
+        if (compare(current->item, key) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Return the first item that compares equal to key, or NULL if there is none
+void* findBy(List* list_pointer, const void* key, ItemCompare compare) {
+    if (list_pointer == NULL || compare == NULL) {
+        return NULL;
+    }
+    for (Node* current = list_pointer->head; current != NULL; current = current->next) {
+        if (compare(current->item, key) == 0) {
+            return current->item;
+        }
+    }
+    return NULL;
+}
+
+// Index items by key so containsKey() and findKey() are O(1)
+int enableHashIndex(List* list_pointer, ItemHash hash, ItemCompare compare) {
+    if (list_pointer == NULL || (hash != NULL && compare == NULL)) {
+        return 1;
+    }
+    dropHashIndex(list_pointer);
+    list_pointer->compare = compare;
+    if (hash == NULL) {
         return 0;
     }
-    Node* current = list_pointer->head;
-    while (current != NULL) { //counting nodes through the entire list
-        count++;
+    int capacity = 16;
+    while (capacity < list_pointer->length * 2) {
+        capacity *= 2;
+    }
+    HashEntry* entries = (HashEntry*)calloc(capacity, sizeof(HashEntry));
+    if (!entries) {
+        return 1;
+    }
+    for (Node* current = list_pointer->head; current != NULL; current = current->next) {
+        hashPlace(entries, capacity, current, hash(current->item));
+    }
+    list_pointer->hash = hash;
+    list_pointer->hashEntries = entries;
+    list_pointer->hashCapacity = capacity;
+    return 0;
+}
+
+// Return the node whose item matches key; any of them if several do
+static Node* hashFind(List* list_pointer, const void* key) {
+    size_t hash = list_pointer->hash(key);
+    size_t mask = (size_t)list_pointer->hashCapacity - 1;
+    for (size_t slot = hash & mask; list_pointer->hashEntries[slot].node != NULL; slot = (slot + 1) & mask) {
+        HashEntry* entry = &list_pointer->hashEntries[slot];
+        if (entry->hash == hash && list_pointer->compare(entry->node->item, key) == 0) {
+            return entry->node;
+        }
+    }
+    return NULL;
+}
+
+// findBy() with the comparator given to enableHashIndex(), through the index
+void* findKey(List* list_pointer, const void* key) {
+    if (list_pointer == NULL) {
+        return NULL;
+    }
+    if (list_pointer->hash == NULL || list_pointer->hashEntries == NULL) {
+        return findBy(list_pointer, key, list_pointer->compare); //index off or dropped
+    }
+    Node* node = hashFind(list_pointer, key);
+    return node ? node->item : NULL;
+}
+
+// containsBy() with the comparator given to enableHashIndex(), through the index
+bool containsKey(List* list_pointer, const void* key) {
+    if (list_pointer == NULL) {
+        return false;
+    }
+    if (list_pointer->hash == NULL || list_pointer->hashEntries == NULL) {
+        return containsBy(list_pointer, key, list_pointer->compare);
+    }
+    return hashFind(list_pointer, key) != NULL;
+}
+
+// Merge two sorted, NULL-terminated chains; ties take from a first so the sort is stable
+static Node* mergeChains(Node* a, Node* b, ItemCompare compare, Node** tail) {
+    Node head;
+    Node* last = &head;
+    while (a != NULL && b != NULL) {
+        if (compare(b->item, a->item) < 0) {
+            last->next = b;
+            b = b->next;
+        } else {
+            last->next = a;
+            a = a->next;
+        }
+        last = last->next;
+    }
+    last->next = a ? a : b;
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    *tail = last;
+    return head.next;
+}
+
+// Detach the first n nodes of *chain and return them; *chain is left at the rest
+static Node* splitChain(Node** chain, int n) {
+    Node* first = *chain;
+    Node* current = first;
+    for (int i = 1; i < n && current != NULL; i++) {
         current = current->next;
     }
+    if (current == NULL) {
+        *chain = NULL;
+    } else {
+        *chain = current->next;
+        current->next = NULL;
+    }
+    return first;
+}
+
+// Stable bottom-up merge sort that relinks nodes instead of moving items
+void sortList(List* list_pointer, ItemCompare compare) {
+    if (list_pointer == NULL || compare == NULL || list_pointer->length < 2) {
+        return;
+    }
+    //merge runs of width 1, 2, 4, ... until one run covers the list; no recursion, no allocation
+    for (int width = 1; width < list_pointer->length; width *= 2) {
+        Node* rest = list_pointer->head;
+        Node head;
+        Node* last = &head;
+        while (rest != NULL) {
+            Node* a = splitChain(&rest, width);
+            Node* b = rest ? splitChain(&rest, width) : NULL;
+            Node* runTail;
+            last->next = mergeChains(a, b, compare, &runTail);
+            last = runTail;
+        }
+        list_pointer->head = head.next;
+        list_pointer->tail = last;
+    }
+    invalidateSkip(list_pointer, 0); //positions changed; the hash index holds nodes, so it is still valid
+}
+
+// Remove items equal to the one before them, keeping the first of each run
+int dedupe(List* list_pointer, ItemCompare compare) {
+    if (list_pointer == NULL || compare == NULL || list_pointer->head == NULL) {
+        return 0;
+    }
+    int removed = 0;
+    Node* current = list_pointer->head;
+    while (current->next != NULL) {
+        Node* next = current->next;
+        if (compare(current->item, next->item) == 0) {
+            current->next = next->next;
+            releaseNode(list_pointer, next);
+            removed++;
+        } else {
+            current = next;
+        }
+    }
+    list_pointer->tail = current;
+    list_pointer->length -= removed;
+    if (removed > 0) {
+        invalidateSkip(list_pointer, 0);
+    }
+    return removed;
+}
 
-    return count; //total number of nodes
+// Merge the sorted list other into the sorted list by relinking nodes
+int mergeSorted(List* list_pointer, List* other, ItemCompare compare) {
+    if (list_pointer == NULL || other == NULL || compare == NULL || list_pointer == other) {
+        return 1;
+    }
+    if (list_pointer->pool != other->pool) {
+        return 1; //nodes must go back to the allocator they came from
+    }
+    if (other->head == NULL) {
+        return 0;
+    }
+    //index other's nodes first; hashAdd expects length to count the node being added
+    int movedCount = other->length;
+    for (Node* current = other->head; current != NULL; current = current->next) {
+        list_pointer->length++;
+        hashAdd(list_pointer, current);
+    }
+    list_pointer->length -= movedCount;
+
+    Node* tail;
+    list_pointer->head = mergeChains(list_pointer->head, other->head, compare, &tail);
+    list_pointer->tail = tail;
+    list_pointer->length += movedCount;
+    invalidateSkip(list_pointer, 0);
+
+    //other gave up its nodes: empty it without freeing them
+    free(other->hashEntries);
+    other->hashEntries = NULL;
+    other->hashCapacity = 0;
+    other->head = NULL;
+    other->tail = NULL;
+    other->length = 0;
+    other->skipCount = 0;
+    return 0;
+}
+
+// Returns the size of the list, measured in nodes.
+int size(List* list_pointer) {
+    if (list_pointer == NULL) { //checks for empty list 
+        return 0;
+    }
+    return list_pointer->length; //maintained by every insert and remove
 }
 
 //helper method for main.c when freeing the list
 void freeList(List* list_pointer) {
+    NodePool* pool = list_pointer->pool;
+    if (pool != NULL && list_pointer->head != NULL) {
+        //the nodes are already chained through next, so splice the whole list onto the freelist
+        list_pointer->tail->next = pool->freeNodes;
+        pool->freeNodes = list_pointer->head;
+        pool->inUse -= list_pointer->length;
+        list_pointer->head = NULL;
+    }
     Node* current = list_pointer->head;
     Node* next = NULL;
     while (current != NULL) {
@@ -248,6 +676,14 @@ void freeList(List* list_pointer) {
     }
     list_pointer->head = NULL;
     list_pointer->tail = NULL;
+    list_pointer->length = 0;
+    list_pointer->skipCount = 0; //keeps the stride so a reused list stays indexed
+    free(list_pointer->skip);
+    list_pointer->skip = NULL;
+    list_pointer->skipCapacity = 0;
+    free(list_pointer->hashEntries); //keeps hash and compare so a reused list stays indexed
+    list_pointer->hashEntries = NULL;
+    list_pointer->hashCapacity = 0;
 }
 
 void printList(List* list) {
@@ -1,6 +1,5 @@
 #include "hashset.hpp"
-#include <iostream>  // For debugging
-#include <chrono>    // For timing measurements
+#include "logger.hpp"  // For debugging
 
 // Constructor: Initialize an empty hash set with a given number of buckets
 HashSet::HashSet(size_t initial_size)
@@ -28,8 +27,6 @@ unsigned long HashSet::hash(unsigned long prehash) const {
 
 // Insert an integer into the set. Returns true if inserted, false if already present.
 bool HashSet::insert(int item) {
-    auto start = std::chrono::high_resolution_clock::now();  // Start timing
-
     unsigned long hash_value = hash(prehash(item));  // Get bucket index
     Node* current = array[hash_value];
 
@@ -52,18 +49,11 @@ bool HashSet::insert(int item) {
         rehash(bucket_count * 2);
     }
 
-    auto end = std::chrono::high_resolution_clock::now();  // End timing
-    // std::cout << "Inserted item " << item << " in "
-    //           << std::chrono::duration<double, std::milli>(end - start).count()
-    //           << " ms.\n";  // Debugging statement
-
     return true;
 }
 
 // Remove an integer from the set. Returns true if removed, false if not found.
 bool HashSet::remove(int item) {
-    auto start = std::chrono::high_resolution_clock::now();  // Start timing
-
     unsigned long hash_value = hash(prehash(item));  // Get bucket index
     Node* current = array[hash_value];
     Node* prev = nullptr;
@@ -80,49 +70,27 @@ bool HashSet::remove(int item) {
             --element_count;  // Decrement element count and update load factor
             updateLoadFactor();
 
-            auto end = std::chrono::high_resolution_clock::now();  // End timing
-            // std::cout << "Removed item " << item << " in "
-            //           << std::chrono::duration<double, std::milli>(end - start).count()
-            //           << " ms.\n";  // Debugging statement
-
             return true;
         }
         prev = current;
         current = current->next;
     }
 
-    auto end = std::chrono::high_resolution_clock::now();  // End timing
-    // std::cout << "Item " << item << " not found for removal. Took "
-    //           << std::chrono::duration<double, std::milli>(end - start).count()
-    //           << " ms.\n";  // Debugging statement
-
     return false;  // Item not found in the set
 }
 
 // Check if an integer exists in the set. Returns true if found, false otherwise.
 bool HashSet::contains(int item) const {
-    auto start = std::chrono::high_resolution_clock::now();  // Start timing
-
     unsigned long hash_value = hash(prehash(item));  // Get bucket index
     Node* current = array[hash_value];
 
     while (current != nullptr) {
         if (current->data == item) {  // Item found in the set
-            auto end = std::chrono::high_resolution_clock::now();  // End timing
-            // std::cout << "Item " << item << " found in "
-            //           << std::chrono::duration<double, std::milli>(end - start).count()
-            //           << " ms.\n";  // Debugging statement
-
             return true;
         }
         current = current->next;
     }
 
-    auto end = std::chrono::high_resolution_clock::now();  // End timing
-    // std::cout << "Item " << item << " not found. Took "
-    //           << std::chrono::duration<double, std::milli>(end - start).count()
-    //           << " ms.\n";  // Debugging statement
-
     return false;  // Item not found in the set
 }
 
@@ -159,6 +127,16 @@ void HashSet::clear() {
     // std::cout << "Cleared all elements from HashSet.\n";  // Debugging statement
 }
 
+// Return the bytes held by the set: the bucket array plus one node per element
+size_t HashSet::memory_usage() const {
+    return bucket_count * sizeof(Node*) + element_count * sizeof(Node);
+}
+
+// Return the number of live heap allocations: the bucket array plus one per node
+size_t HashSet::allocation_count() const {
+    return 1 + element_count;
+}
+
 // Update the load factor based on element count and bucket count
 void HashSet::updateLoadFactor() {
     load_factor =
@@ -190,7 +168,5 @@ void HashSet::rehash(size_t new_size) {
 
     delete[] old_array;             // Free memory for old array of buckets after rehashing is complete
 
-    std::cout << "Rehashed from " << old_bucket_count
-              << " buckets to " << bucket_count
-              << ".\n";   // Debugging statement to track rehashing.
+    LOG_DEBUG("Rehashed from %zu buckets to %zu.", old_bucket_count, bucket_count);   // Compiled out unless debug logging is enabled
 }
@@ -10,9 +10,52 @@ typedef struct Node{
 	struct Node*  next;
 }Node;
 
+// Nodes are carved from slabs of NODE_POOL_SLAB_NODES and recycled through
+// a freelist threaded through Node.next, so a pooled list only calls malloc
+// once per slab and never calls free until the pool is destroyed.
+#define NODE_POOL_SLAB_NODES 256
+
+typedef struct NodeSlab{
+	struct NodeSlab* next;
+	Node nodes[NODE_POOL_SLAB_NODES];
+}NodeSlab;
+
+typedef struct {
+	NodeSlab* slabs;  // Every slab, newest first
+	Node* freeNodes;  // Recycled nodes
+	int slabUsed;     // Nodes handed out from the newest slab
+	int inUse;        // Nodes currently owned by lists
+}NodePool;
+
+// Orders two items like strcmp: negative, zero (same key) or positive
+typedef int (*ItemCompare)(const void* a, const void* b);
+// Hashes an item's key; items that compare equal must hash equal
+typedef size_t (*ItemHash)(const void* item);
+
+// Slot of the optional hash index: one per node, NULL node when empty
+typedef struct {
+	Node* node;
+	size_t hash;
+}HashEntry;
+
 typedef struct {
 	Node* head;
 	Node* tail;
+	int length;        // Number of nodes, kept up to date so size() is O(1)
+	// Optional skip index: skip[k] is the node at position k * skipStride.
+	// Only the first skipCount entries are valid; changes in the middle of
+	// the list truncate it and indexed operations extend it again lazily.
+	Node** skip;
+	int skipStride;    // 0 when the index is disabled
+	int skipCount;
+	int skipCapacity;
+	NodePool* pool;    // Where nodes come from; NULL means malloc/free
+	// Optional hash index over item keys (open addressing, linear probing),
+	// kept up to date by every insert and remove so containsKey() is O(1).
+	ItemHash hash;     // NULL when the index is disabled
+	ItemCompare compare;
+	HashEntry* hashEntries;
+	int hashCapacity;  // Slots, a power of two, at least twice length
 }List;
 
 // Initialize an empty list
@@ -48,12 +91,58 @@ bool contains(List* list_pointer, void* item);
 // Returns the size of the list, measured in nodes.
 int size(List* list_pointer);
 
+// Return true if some item compares equal to key, using compare(item, key)
+bool containsBy(List* list_pointer, const void* key, ItemCompare compare);
+
+// Return the first item that compares equal to key, or NULL if there is none
+void* findBy(List* list_pointer, const void* key, ItemCompare compare);
+
+// Index items by key so containsKey() and findKey() are O(1). The index is
+// rebuilt from the current nodes; a NULL hash turns it off. If memory runs
+// out while growing, the index is turned off and lookups scan the list.
+int enableHashIndex(List* list_pointer, ItemHash hash, ItemCompare compare);
+
+// findBy() with the comparator given to enableHashIndex(), through the index
+void* findKey(List* list_pointer, const void* key);
+
+// containsBy() with the comparator given to enableHashIndex(), through the index
+bool containsKey(List* list_pointer, const void* key);
+
+// Stable merge sort that relinks nodes instead of moving items: O(n log n)
+// comparisons, no allocation
+void sortList(List* list_pointer, ItemCompare compare);
+
+// Remove items equal to the one before them, keeping the first of each run.
+// On a sorted list this removes every duplicate. Returns how many went.
+int dedupe(List* list_pointer, ItemCompare compare);
+
+// Merge the sorted list other into the sorted list by relinking nodes; other
+// is empty afterwards. Both lists must take nodes from the same pool (or both
+// from malloc). Returns 0 on success, 1 otherwise.
+int mergeSorted(List* list_pointer, List* other, ItemCompare compare);
+
+// Keep a pointer to every stride-th node so indexed operations walk at most
+// stride nodes instead of up to the whole list. A stride of 0 turns it off.
+int enableSkipIndex(List* list_pointer, int stride);
+
 // Print List
 void printList(List* list_pointer);
 
 //helper method for main.c when freeing the list
+//With a node pool this hands the whole chain back to the pool in O(1).
 void freeList(List* list_pointer);
 
+// Initialize an empty node pool
+void initNodePool(NodePool* pool);
+
+// Free every slab at once. Lists still using the pool must not be used
+// again until they are re-initialized with initList.
+void destroyNodePool(NodePool* pool);
+
+// Take nodes for this list from pool (which may be shared by several lists).
+// Only allowed while the list is empty; returns 0 on success, 1 otherwise.
+int useNodePool(List* list_pointer, NodePool* pool);
+
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include <iostream>         // For console output
+#include <list>             // For std::list
+#include <vector>           // For sample indices
+#include <string>           // For std::stoi
+#include <chrono>           // For high-resolution timing
+#include <iomanip>          // For output formatting
+#include <algorithm>        // For std::find
+#include <random>           // For random lookup keys and indices
+#include <cstdint>          // For intptr_t
+#include <utility>          // For std::pair
+extern "C" {
+#include "linkedlist.h"     // C singly linked list (lib.c)
+}
+#include "unrolledlist.h"   // C unrolled list (unrolledlist.c)
+
+// Compares the C List, the C UnrolledList and std::list, following the
+// recitation 5 setup in README.md: N tail insertions, lookups of values,
+// indexed reads and deletions from the head, for growing N.
+//
+// Build (the C files are compiled as C):
+//   gcc -std=c11 -O2 -c lib.c -o linkedlist.o
+//   gcc -std=c11 -O2 -c unrolledlist.c -o unrolledlist.o
+//   g++ -std=c++17 -O2 list_benchmark.cpp linkedlist.o unrolledlist.o -o list_benchmark
+// Usage: list_benchmark [max N]   (default 100000; N runs 10^3 up to max N)
+
+// Lookups and indexed reads are O(n) each on every list, so only this many are timed
+const int SAMPLE_OPS = 1000;
+// Stride of List's skip index in the "List+skip" rows
+const int SKIP_STRIDE = 64;
+
+using Clock = std::chrono::steady_clock;
+
+// Average nanoseconds per operation between start and end
+double nsPerOp(Clock::time_point start, Clock::time_point end, int ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+struct ListTimes {
+    double insert_ns;
+    double lookup_ns;
+    double index_ns;
+    double remove_ns;
+    size_t bytes;  // Bytes in nodes/blocks, not counting allocator headers
+};
+
+// stride > 0 enables List's skip index
+ListTimes benchmarkList(int n, const std::vector<int>& keys, const std::vector<int>& indices, int stride) {
+    ListTimes t;
+    List list;
+    initList(&list);
+    enableSkipIndex(&list, stride);
+    auto start = Clock::now();
+    for (int i = 0; i < n; i++) insertAtTail(&list, (void*)(intptr_t)i);
+    t.insert_ns = nsPerOp(start, Clock::now(), n);
+    t.bytes = static_cast<size_t>(n) * sizeof(Node);
+
+    volatile bool found = false;
+    start = Clock::now();
+    for (int key : keys) found = contains(&list, (void*)(intptr_t)key);
+    t.lookup_ns = nsPerOp(start, Clock::now(), keys.size());
+
+    volatile void* item = nullptr;
+    start = Clock::now();
+    for (int index : indices) item = itemAtIndex(&list, index);
+    t.index_ns = nsPerOp(start, Clock::now(), indices.size());
+
+    start = Clock::now();
+    for (int i = 0; i < n; i++) item = removeHead(&list);
+    t.remove_ns = nsPerOp(start, Clock::now(), n);
+    (void)found;
+    (void)item;
+    freeList(&list);
+    return t;
+}
+
+// Appends with an indexed read of a random position after every tenth one:
+// quadratic on a plain List, close to linear with the skip index
+double indexedMixList(int n, int stride) {
+    List list;
+    initList(&list);
+    enableSkipIndex(&list, stride);
+    std::mt19937 rng(7);
+    volatile void* item = nullptr;
+    auto start = Clock::now();
+    for (int i = 0; i < n; i++) {
+        insertAtTail(&list, (void*)(intptr_t)i);
+        if (i % 10 == 9) item = itemAtIndex(&list, rng() % (i + 1));
+    }
+    double ns = nsPerOp(start, Clock::now(), n);
+    (void)item;
+    freeList(&list);
+    return ns;
+}
+
+double indexedMixUnrolled(int n) {
+    UnrolledList list;
+    initUnrolledList(&list);
+    std::mt19937 rng(7);
+    volatile void* item = nullptr;
+    auto start = Clock::now();
+    for (int i = 0; i < n; i++) {
+        unrolledInsertAtTail(&list, (void*)(intptr_t)i);
+        if (i % 10 == 9) item = unrolledItemAtIndex(&list, rng() % (i + 1));
+    }
+    double ns = nsPerOp(start, Clock::now(), n);
+    (void)item;
+    freeUnrolledList(&list);
+    return ns;
+}
+
+// FIFO queue churn: keep depth items queued and push/pop n times, then tear
+// the list down. With a pool, only the first depth pushes reach malloc.
+double queueChurnList(int n, int depth, bool pooled) {
+    NodePool pool;
+    initNodePool(&pool);
+    List list;
+    initList(&list);
+    if (pooled) useNodePool(&list, &pool);
+    volatile void* item = nullptr;
+    auto start = Clock::now();
+    for (int i = 0; i < depth; i++) insertAtTail(&list, (void*)(intptr_t)i);
+    for (int i = 0; i < n; i++) {
+        insertAtTail(&list, (void*)(intptr_t)i);
+        item = removeHead(&list);
+    }
+    freeList(&list);
+    destroyNodePool(&pool);
+    double ns = nsPerOp(start, Clock::now(), n);
+    (void)item;
+    return ns;
+}
+
+// Items in the key-lookup and sort rows are the ints themselves
+int compareInts(const void* a, const void* b) {
+    intptr_t x = (intptr_t)a, y = (intptr_t)b;
+    return x < y ? -1 : x > y;
+}
+
+size_t hashInt(const void* item) {
+    return static_cast<size_t>((intptr_t)item) * 0x9E3779B97F4A7C15ull;
+}
+
+// Key lookups through containsBy() (scan) or containsKey() (hash index),
+// then a sortList() of the shuffled values; returns {lookup ns, sort ns per item}
+std::pair<double, double> keyedList(int n, const std::vector<int>& keys, bool hashed) {
+    List list;
+    initList(&list);
+    if (hashed) enableHashIndex(&list, hashInt, compareInts);
+    std::vector<int> values(n);
+    for (int i = 0; i < n; i++) values[i] = i;
+    std::shuffle(values.begin(), values.end(), std::mt19937(3));
+    for (int v : values) insertAtTail(&list, (void*)(intptr_t)v);
+
+    volatile bool found = false;
+    auto start = Clock::now();
+    for (int key : keys) {
+        found = hashed ? containsKey(&list, (void*)(intptr_t)key) : containsBy(&list, (void*)(intptr_t)key, compareInts);
+    }
+    double lookup = nsPerOp(start, Clock::now(), keys.size());
+    start = Clock::now();
+    sortList(&list, compareInts);
+    double sort = nsPerOp(start, Clock::now(), n);
+    (void)found;
+    freeList(&list);
+    return {lookup, sort};
+}
+
+ListTimes benchmarkUnrolled(int n, const std::vector<int>& keys, const std::vector<int>& indices) {
+    ListTimes t;
+    UnrolledList list;
+    initUnrolledList(&list);
+    auto start = Clock::now();
+    for (int i = 0; i < n; i++) unrolledInsertAtTail(&list, (void*)(intptr_t)i);
+    t.insert_ns = nsPerOp(start, Clock::now(), n);
+    size_t blocks = 0;
+    for (Block* b = list.head; b != nullptr; b = b->next) blocks++;
+    t.bytes = blocks * sizeof(Block);
+
+    volatile bool found = false;
+    start = Clock::now();
+    for (int key : keys) found = unrolledContains(&list, (void*)(intptr_t)key);
+    t.lookup_ns = nsPerOp(start, Clock::now(), keys.size());
+
+    volatile void* item = nullptr;
+    start = Clock::now();
+    for (int index : indices) item = unrolledItemAtIndex(&list, index);
+    t.index_ns = nsPerOp(start, Clock::now(), indices.size());
+
+    start = Clock::now();
+    for (int i = 0; i < n; i++) item = unrolledRemoveHead(&list);
+    t.remove_ns = nsPerOp(start, Clock::now(), n);
+    (void)found;
+    (void)item;
+    freeUnrolledList(&list);
+    return t;
+}
+
+ListTimes benchmarkStdList(int n, const std::vector<int>& keys, const std::vector<int>& indices) {
+    ListTimes t;
+    std::list<int> list;
+    auto start = Clock::now();
+    for (int i = 0; i < n; i++) list.push_back(i);
+    t.insert_ns = nsPerOp(start, Clock::now(), n);
+    // libstdc++ nodes hold two pointers and the value, padded to pointer alignment
+    t.bytes = static_cast<size_t>(n) * (2 * sizeof(void*) + sizeof(void*));
+
+    volatile bool found = false;
+    start = Clock::now();
+    for (int key : keys) found = std::find(list.begin(), list.end(), key) != list.end();
+    t.lookup_ns = nsPerOp(start, Clock::now(), keys.size());
+
+    volatile int item = 0;
+    start = Clock::now();
+    for (int index : indices) item = *std::next(list.begin(), index);
+    t.index_ns = nsPerOp(start, Clock::now(), indices.size());
+
+    start = Clock::now();
+    for (int i = 0; i < n; i++) {
+        item = list.front();
+        list.pop_front();
+    }
+    t.remove_ns = nsPerOp(start, Clock::now(), n);
+    (void)found;
+    (void)item;
+    return t;
+}
+
+void printRow(const char* name, int n, const ListTimes& t) {
+    std::cout << std::left << std::setw(14) << name << std::right << std::setw(10) << n
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << t.insert_ns << std::setw(14) << t.lookup_ns
+              << std::setw(14) << t.index_ns << std::setw(12) << t.remove_ns
+              << std::setw(14) << static_cast<double>(t.bytes) / n << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    int max_n = argc > 1 ? std::stoi(argv[1]) : 100000;
+
+    std::cout << std::left << std::setw(14) << "Structure" << std::right << std::setw(10) << "N"
+              << std::setw(12) << "Insert ns" << std::setw(14) << "Lookup ns"
+              << std::setw(14) << "Index ns" << std::setw(12) << "Remove ns"
+              << std::setw(14) << "Bytes/item" << "\n";
+
+    for (int n = 1000; n <= max_n; n *= 10) {
+        // The same random values and positions for every structure
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        std::vector<int> keys(SAMPLE_OPS), indices(SAMPLE_OPS);
+        for (int& k : keys) k = pick(rng);
+        for (int& i : indices) i = pick(rng);
+
+        printRow("List", n, benchmarkList(n, keys, indices, 0));
+        printRow("List+skip", n, benchmarkList(n, keys, indices, SKIP_STRIDE));
+        printRow("UnrolledList", n, benchmarkUnrolled(n, keys, indices));
+        printRow("std::list", n, benchmarkStdList(n, keys, indices));
+    }
+
+    std::cout << "\nAppends with an indexed read every 10th append (ns per append)\n";
+    std::cout << std::left << std::setw(14) << "Structure" << std::right << std::setw(10) << "N"
+              << std::setw(12) << "ns/op" << "\n";
+    for (int n = 1000; n <= max_n; n *= 10) {
+        std::cout << std::left << std::setw(14) << "List" << std::right << std::setw(10) << n
+                  << std::setw(12) << indexedMixList(n, 0) << "\n";
+        std::cout << std::left << std::setw(14) << "List+skip" << std::right << std::setw(10) << n
+                  << std::setw(12) << indexedMixList(n, SKIP_STRIDE) << "\n";
+        std::cout << std::left << std::setw(14) << "UnrolledList" << std::right << std::setw(10) << n
+                  << std::setw(12) << indexedMixUnrolled(n) << "\n";
+    }
+
+    std::cout << "\nKey lookups by comparator scan vs hash index, and sortList of shuffled items\n";
+    std::cout << std::left << std::setw(14) << "Structure" << std::right << std::setw(10) << "N"
+              << std::setw(12) << "Lookup ns" << std::setw(14) << "Sort ns/item" << "\n";
+    for (int n = 1000; n <= max_n; n *= 10) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> pick(0, 2 * n - 1);  // About half the keys miss
+        std::vector<int> keys(SAMPLE_OPS);
+        for (int& k : keys) k = pick(rng);
+        std::pair<double, double> scan = keyedList(n, keys, false);
+        std::pair<double, double> hashed = keyedList(n, keys, true);
+        std::cout << std::left << std::setw(14) << "List" << std::right << std::setw(10) << n
+                  << std::setw(12) << scan.first << std::setw(14) << scan.second << "\n";
+        std::cout << std::left << std::setw(14) << "List+hash" << std::right << std::setw(10) << n
+                  << std::setw(12) << hashed.first << std::setw(14) << hashed.second << "\n";
+    }
+
+    std::cout << "\nQueue churn: insertAtTail + removeHead with 1000 queued (ns per pair, incl. teardown)\n";
+    std::cout << std::left << std::setw(14) << "Structure" << std::right << std::setw(10) << "N"
+              << std::setw(12) << "ns/op" << "\n";
+    for (int n = 1000; n <= max_n * 10; n *= 10) {
+        std::cout << std::left << std::setw(14) << "List" << std::right << std::setw(10) << n
+                  << std::setw(12) << queueChurnList(n, 1000, false) << "\n";
+        std::cout << std::left << std::setw(14) << "List+pool" << std::right << std::setw(10) << n
+                  << std::setw(12) << queueChurnList(n, 1000, true) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "linkedlist.h"
+
+//Behaviour tests for the List hash index, sortList, dedupe and mergeSorted.
+//Items are Entry pointers compared by key only, so seq tells equal keys apart
+//and shows whether an operation kept them in order. Every hash index answer is
+//checked against a plain scan with containsBy.
+//
+//Build: gcc -std=gnu11 -Wall list_test.c lib.c -o list_test
+//Usage: list_test
+
+#define KEYS 50        //keys used by the tests; lookups also try KEYS..KEYS+9, which are never inserted
+#define ENTRIES 500
+
+typedef struct {
+    int key;
+    int seq;  //insertion order
+} Entry;
+
+static Entry entries[ENTRIES];
+static Entry others[ENTRIES];
+
+static int compareKey(const void* a, const void* b) {
+    int x = ((const Entry*)a)->key, y = ((const Entry*)b)->key;
+    return x < y ? -1 : x > y;
+}
+
+static size_t hashKey(const void* item) {
+    return (size_t)((const Entry*)item)->key * 2654435761u;
+}
+
+static void check(const char* label, bool passed) {
+    printf("%s: ", label);
+    if (passed) {
+        printf("Passed\n");
+    } else {
+        printf("Failed\n");
+        exit(1);
+    }
+}
+
+//Every key, present or not, gets the same answer from the index as from a scan,
+//and findKey only returns items that are still in the list
+static bool indexAgreesWithScan(List* list) {
+    for (int key = 0; key < KEYS + 10; key++) {
+        Entry probe = {key, 0};
+        bool scanned = containsBy(list, &probe, compareKey);
+        if (containsKey(list, &probe) != scanned) {
+            return false;
+        }
+        Entry* found = (Entry*)findKey(list, &probe);
+        if (scanned ? found == NULL || found->key != key || !contains(list, found) : found != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//Keys never decrease and equal keys keep increasing seq
+static bool sortedStable(List* list) {
+    for (Node* current = list->head; current != NULL && current->next != NULL; current = current->next) {
+        const Entry* a = (const Entry*)current->item;
+        const Entry* b = (const Entry*)current->next->item;
+        if (a->key > b->key || (a->key == b->key && a->seq > b->seq)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//length and tail match the nodes actually linked
+static bool shapeMatches(List* list) {
+    int count = 0;
+    Node* last = NULL;
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        last = current;
+        count++;
+    }
+    return count == list->length && last == list->tail;
+}
+
+int main(void) {
+    srand(1);
+
+    //duplicates: four of every key, half indexed by the rebuild and half by inserts
+    List list;
+    initList(&list);
+    bool ok = true;
+    for (int i = 0; i < 4 * KEYS; i++) {
+        entries[i] = (Entry){i % KEYS, i};
+        if (i == 2 * KEYS) {
+            ok = ok && enableHashIndex(&list, hashKey, compareKey) == 0;
+        }
+        ok = ok && (i % 3 == 0 ? insertAtHead(&list, &entries[i]) : insertAtIndex(&list, size(&list) / 2, &entries[i])) == 0;
+    }
+    check("Test 1 - index finds every duplicated key", ok && size(&list) == 4 * KEYS && indexAgreesWithScan(&list));
+
+    //removing with the index on: a key stays found until its last copy goes
+    ok = true;
+    while (size(&list) > 0 && ok) {
+        int kind = rand() % 3;
+        void* removed = kind == 0 ? removeHead(&list) : kind == 1 ? removeTail(&list) : removeAtIndex(&list, rand() % size(&list));
+        ok = removed != NULL && indexAgreesWithScan(&list);
+    }
+    check("Test 2 - removes keep the index in step", ok && list.head == NULL);
+
+    //sort stability on many equal keys, with the index still on
+    for (int i = 0; i < ENTRIES; i++) {
+        entries[i] = (Entry){rand() % 20, i};
+        insertAtTail(&list, &entries[i]);
+    }
+    sortList(&list, compareKey);
+    check("Test 3 - sortList is stable", sortedStable(&list) && shapeMatches(&list) && size(&list) == ENTRIES);
+    check("Test 4 - index survives sortList", indexAgreesWithScan(&list));
+
+    //dedupe keeps the first (lowest seq, after a stable sort) of each key
+    int firstSeq[20];
+    int distinct = 0;
+    for (int k = 0; k < 20; k++) {
+        firstSeq[k] = -1;
+    }
+    for (int i = 0; i < ENTRIES; i++) {
+        if (firstSeq[entries[i].key] < 0) {
+            firstSeq[entries[i].key] = i;
+            distinct++;
+        }
+    }
+    int removed = dedupe(&list, compareKey);
+    ok = removed == ENTRIES - distinct && size(&list) == distinct && shapeMatches(&list);
+    for (Node* current = list.head; current != NULL; current = current->next) {
+        const Entry* e = (const Entry*)current->item;
+        ok = ok && e->seq == firstSeq[e->key];
+    }
+    check("Test 5 - dedupe keeps the first of each run", ok);
+    check("Test 6 - index survives dedupe", indexAgreesWithScan(&list) && dedupe(&list, compareKey) == 0);
+    freeList(&list);
+
+    //merge two pooled lists into an indexed one; ties keep the receiving list's items first
+    NodePool pool;
+    initNodePool(&pool);
+    List merged, other;
+    initList(&merged);
+    initList(&other);
+    ok = useNodePool(&merged, &pool) == 0 && useNodePool(&other, &pool) == 0;
+    ok = ok && enableHashIndex(&merged, hashKey, compareKey) == 0;
+    for (int i = 0; i < ENTRIES / 2; i++) {
+        entries[i] = (Entry){(i * 2) % KEYS, i};             //even keys
+        others[i] = (Entry){(i * 3) % KEYS, ENTRIES + i};   //every key, seq after all of entries
+        insertAtTail(&merged, &entries[i]);
+        insertAtTail(&other, &others[i]);
+    }
+    sortList(&merged, compareKey);
+    sortList(&other, compareKey);
+    ok = ok && mergeSorted(&merged, &other, compareKey) == 0;
+    check("Test 7 - mergeSorted of pooled lists", ok && size(&merged) == ENTRIES && size(&other) == 0 &&
+          other.head == NULL && sortedStable(&merged) && shapeMatches(&merged));
+    check("Test 8 - index covers the merged-in nodes", indexAgreesWithScan(&merged) && pool.inUse == ENTRIES);
+
+    ok = removeHead(&merged) != NULL && removeAtIndex(&merged, size(&merged) / 2) != NULL && indexAgreesWithScan(&merged);
+    ok = ok && insertAtTail(&other, &others[0]) == 0 && size(&other) == 1;
+    check("Test 9 - both lists stay usable after a merge", ok && pool.inUse == ENTRIES - 1);
+
+    //lists with different allocators can't trade nodes
+    List unpooled;
+    initList(&unpooled);
+    insertAtTail(&unpooled, &entries[0]);
+    ok = mergeSorted(&merged, &unpooled, compareKey) == 1 && size(&unpooled) == 1 && size(&merged) == ENTRIES - 2;
+    check("Test 10 - mergeSorted refuses lists from another pool", ok);
+
+    freeList(&unpooled);
+    freeList(&merged);
+    freeList(&other);
+    check("Test 11 - every pooled node returned", pool.inUse == 0);
+    destroyNodePool(&pool);
+    return 0;
+}
@@ -0,0 +1,212 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <pthread.h>
+#include <signal.h>
+
+// Leveled asynchronous logger.
+//
+// LOG_DEBUG/LOG_INFO/LOG_WARN/LOG_ERROR take printf-style arguments. The
+// calling thread formats the message straight into a slot of a fixed-size
+// lock-free ring buffer and returns; a background thread drains the ring to
+// stdout (DEBUG, INFO) or stderr (WARN, ERROR) and flushes once per batch
+// rather than once per line. When the ring is full messages are dropped and
+// counted instead of blocking the caller.
+//
+// Levels below LOG_MIN_LEVEL compile to nothing; build with
+// -DLOG_MIN_LEVEL=LOG_LEVEL_DEBUG to see per-request debug output. Each call
+// site logs at most LOG_RATE_LIMIT messages per second and reports how many
+// it suppressed on its next line.
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_RATE_LIMIT
+#define LOG_RATE_LIMIT 1000
+#endif
+
+namespace logger {
+
+    const size_t SLOT_COUNT = 1024;  // Power of two
+    const size_t TEXT_SIZE = 240;    // Longer messages are truncated
+
+    // Allows up to limit calls per one-second window
+    class RateLimiter {
+    private:
+        std::atomic<int64_t> window;
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> suppressed;
+        uint32_t limit;
+
+    public:
+        explicit RateLimiter(uint32_t per_second) : window(0), count(0), suppressed(0), limit(per_second) {}
+
+        // On success, suppressed_since receives the calls dropped since the last success
+        bool allow(uint32_t& suppressed_since) {
+            int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t current = window.load(std::memory_order_relaxed);
+            if (now != current && window.compare_exchange_strong(current, now, std::memory_order_relaxed)) {
+                count.store(0, std::memory_order_relaxed);
+            }
+            if (count.fetch_add(1, std::memory_order_relaxed) < limit) {
+                suppressed_since = suppressed.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    };
+
+    class AsyncLogger {
+    private:
+        // Bounded multi-producer queue after Dmitry Vyukov's design: a slot is
+        // free for position p when its sequence is p and holds a message when
+        // its sequence is p + 1
+        struct Slot {
+            std::atomic<size_t> sequence;
+            int level;
+            char text[TEXT_SIZE];
+        };
+
+        Slot slots[SLOT_COUNT];
+        std::atomic<size_t> enqueue_pos;
+        size_t dequeue_pos;  // Only touched by the worker
+        std::atomic<uint64_t> dropped;
+        std::atomic<bool> stopping;
+        std::thread worker;
+
+        static const char* prefix(int level) {
+            switch (level) {
+                case LOG_LEVEL_DEBUG: return "[DEBUG] ";
+                case LOG_LEVEL_INFO: return "[INFO] ";
+                case LOG_LEVEL_WARN: return "[WARN] ";
+                default: return "[ERROR] ";
+            }
+        }
+
+        // Write out everything queued; returns whether anything was written
+        bool drain() {
+            bool wrote_out = false, wrote_err = false;
+            FILE* last = nullptr;
+            for (;;) {
+                Slot& slot = slots[dequeue_pos & (SLOT_COUNT - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) break;
+                FILE* stream = slot.level >= LOG_LEVEL_WARN ? stderr : stdout;
+                // Keep stdout and stderr lines in order when both go to a terminal
+                if (last != nullptr && stream != last) std::fflush(last);
+                last = stream;
+                std::fputs(prefix(slot.level), stream);
+                std::fputs(slot.text, stream);
+                std::fputc('\n', stream);
+                (stream == stderr ? wrote_err : wrote_out) = true;
+                slot.sequence.store(dequeue_pos + SLOT_COUNT, std::memory_order_release);
+                dequeue_pos++;
+            }
+            uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+            if (lost > 0) {
+                std::fprintf(stderr, "[WARN] Logger queue full, dropped %llu messages\n",
+                             static_cast<unsigned long long>(lost));
+                wrote_err = true;
+            }
+            if (wrote_out) std::fflush(stdout);
+            if (wrote_err) std::fflush(stderr);
+            return wrote_out || wrote_err;
+        }
+
+        void run() {
+            while (!stopping.load(std::memory_order_acquire)) {
+                if (!drain()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            drain();
+        }
+
+    public:
+        AsyncLogger() : enqueue_pos(0), dequeue_pos(0), dropped(0), stopping(false) {
+            for (size_t i = 0; i < SLOT_COUNT; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+            // The worker inherits a fully blocked mask so signals go to the application's threads
+            sigset_t all, previous;
+            sigfillset(&all);
+            pthread_sigmask(SIG_SETMASK, &all, &previous);
+            worker = std::thread(&AsyncLogger::run, this);
+            pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        }
+
+        // Flushes whatever is still queued at exit
+        ~AsyncLogger() {
+            stopping.store(true, std::memory_order_release);
+            if (worker.joinable()) worker.join();
+        }
+
+        AsyncLogger(const AsyncLogger&) = delete;
+        AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+        void write(int level, uint32_t suppressed, const char* format, va_list args) {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            Slot* slot;
+            for (;;) {
+                slot = &slots[pos & (SLOT_COUNT - 1)];
+                size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);  // Full
+                    return;
+                } else {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            slot->level = level;
+            int length = std::vsnprintf(slot->text, TEXT_SIZE, format, args);
+            if (suppressed > 0 && length >= 0 && static_cast<size_t>(length) < TEXT_SIZE) {
+                std::snprintf(slot->text + length, TEXT_SIZE - length, " (%u similar messages suppressed)", suppressed);
+            }
+            slot->sequence.store(pos + 1, std::memory_order_release);
+        }
+    };
+
+    inline AsyncLogger& instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    __attribute__((format(printf, 3, 4)))
+    inline void write(int level, uint32_t suppressed, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        instance().write(level, suppressed, format, args);
+        va_end(args);
+    }
+
+}
+
+#define LOG_AT(level, ...)                                                  \
+    do {                                                                    \
+        if ((level) >= LOG_MIN_LEVEL) {                                     \
+            static logger::RateLimiter log_limiter_(LOG_RATE_LIMIT);        \
+            uint32_t log_suppressed_ = 0;                                   \
+            if (log_limiter_.allow(log_suppressed_))                        \
+                logger::write((level), log_suppressed_, __VA_ARGS__);       \
+        }                                                                   \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif // LOGGER_HPP
@@ -1,72 +1,106 @@
 #include <iostream>  // For input/output operations
-#include <sstream>   // For std::istringstream, string stream processing
-#include <cstdio>    // For file operations (fopen, fclose, etc.)
+#include <fstream>   // For reading the whole test file at once
+#include <iterator>  // For std::istreambuf_iterator
+#include <string>    // For std::string, std::stoul
+#include <vector>    // For the compiled instruction array
+#include <chrono>    // For timing replays
+#include <random>    // For generated traces
+#include <unordered_set>  // Reference set when generating traces
+#include <climits>   // For UINT_MAX
 #include <cstdlib>   // For general purpose functions
-#include "hash_set.h"  // Custom hash set implementation
+#include "hashset.hpp"   // Custom hash set implementation (lib.cpp)
+#include "workload.hpp"  // parseBytecode()
 
-//using c instead of .h above due to c++ style
+// Runs the hash set bytecode tests (format at the top of tests). The file is
+// compiled once into an array of Instructions, split into tests at each X, and
+// the interpreter then just walks that array, so the same code serves as a
+// conformance runner and, with --replay, as a benchmark of HashSet under any
+// recorded or generated trace. There is no limit on test count or length.
+//
+// Usage: main [file]                              run the tests (default /tests/tests)
+//        main --replay [file] [--repeat N]        time N runs, report instructions/sec
+//        main --generate TESTS OPS [--keys K] [--buckets B] [--seed S]
+//                                                 print a random trace with correct assertions
 
-// Maximum number of test cases to process
-const int TESTS = 100;
-// Maximum length of each test case string
-const int TEST_LENGTH = 1000;
+// One test: instructions [begin, end) of the compiled program, ending with its X
+struct TestRange {
+    size_t begin;
+    size_t end;
+};
 
-// Function to run a single test case
-bool runTest(const char* testCase) {
-    std::istringstream iss(testCase); //Creates an input string stream from the test case string, allowing easy parsing of space-separated values
-    char operation;
-    int value;
-    HashSet<int>* set = nullptr; //c++11 :- null pointer, Declares a pointer to a HashSet<int> and initializes it to nullptr
-    bool testPassed = true;
+// The compiled test file
+struct CompiledTests {
+    std::vector<Instruction> code;
+    std::vector<TestRange> tests;
+};
 
-	//iss: std::istringstream is a class that allows you to treat a string as an input stream
+// Load factor as the tests write it: a percentage rounded to the nearest integer
+unsigned long roundedLoad(size_t count, size_t buckets) {
+    return (count * 100 + buckets / 2) / buckets;
+}
 
-    // Process each operation in the test case
-    while (iss >> operation) {
-        switch (operation) {
+// Compile bytecode text; instructions after the last X form a final test
+CompiledTests compileTests(const std::string& text) {
+    CompiledTests compiled;
+    compiled.code = parseBytecode(text.data(), text.size());
+    size_t begin = 0;
+    for (size_t i = 0; i < compiled.code.size(); i++) {
+        if (compiled.code[i].code == 'X') {
+            compiled.tests.push_back({begin, i + 1});
+            begin = i + 1;
+        }
+    }
+    if (begin < compiled.code.size()) compiled.tests.push_back({begin, compiled.code.size()});
+    return compiled;
+}
+
+// Run one compiled test
+bool runTest(const Instruction* ins, const Instruction* end) {
+    HashSet* set = nullptr;
+    size_t buckets = 0;
+    bool testPassed = true;
+
+    for (; ins != end; ++ins) {
+        int value = ins->value;
+        if (ins->code != 'H' && ins->code != 'X' && set == nullptr) {
+            testPassed = false;  // No set to operate on before the first H
+            continue;
+        }
+        switch (ins->code) {
             case 'H': // Create hash set
-                iss >> value;
                 delete set; // Delete previous set if exists
-                set = new HashSet<int>(value, false);
+                set = nullptr;
+                if (value <= 0) {
+                    testPassed = false;
+                    break;
+                }
+                buckets = static_cast<size_t>(value);
+                set = new HashSet(buckets);
+                set->set_load_threshold(UINT_MAX);  // The tests expect a fixed bucket count
                 break;
             case 'I': // Insert item
-                iss >> value;
-                set->Add(value);
+                set->insert(value);
                 break;
             case 'R': // Remove item
-                iss >> value;
-                set->Remove(value);
+                set->remove(value);
                 break;
             case 'C': // Assert contains
-                iss >> value;
-                if (!set->Exists(value)) {
-                    testPassed = false;
-                }
+                if (!set->contains(value)) testPassed = false;
                 break;
             case 'D': // Assert doesn't contain
-                iss >> value;
-                if (set->Exists(value)) {
-                    testPassed = false;
-                }
+                if (set->contains(value)) testPassed = false;
                 break;
             case 'S': // Assert size
-                iss >> value;
-                if (set->Size() != value) {
-                    testPassed = false;
-                }
+                if (set->count() != static_cast<size_t>(value)) testPassed = false;
                 break;
             case 'L': // Assert load factor
-                iss >> value;
-                if (set->LoadFactor() != value) {
-                    testPassed = false;
-                }
+                if (roundedLoad(set->count(), buckets) != static_cast<unsigned long>(value)) testPassed = false;
                 break;
             case 'X': // End of test
                 delete set;
-                set = nullptr;
                 return testPassed;
             default:
-                std::cout << "Unknown operation: " << operation << std::endl;
+                std::cout << "Unknown operation: " << ins->code << std::endl;
                 testPassed = false;
         }
     }
@@ -74,33 +108,104 @@ bool runTest(const char* testCase) {
     return testPassed;
 }
 
-int main() {
-    // Open the test file
-    FILE* file = std::fopen("/tests/tests", "r");
+// Write tests random tests of ops instructions each, with assertions that
+// hold for a correct set: the expected answers come from std::unordered_set
+void generateTrace(std::ostream& out, size_t tests, size_t ops, int keys, int buckets, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> key(-keys / 2, keys - keys / 2 - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    out << "-- Generated: " << tests << " tests x " << ops << " ops, keys " << keys
+        << ", buckets " << buckets << ", seed " << seed << "\n";
+    for (size_t t = 0; t < tests; t++) {
+        std::unordered_set<int> reference;
+        std::string line = "H" + std::to_string(buckets);
+        for (size_t i = 0; i < ops; i++) {
+            int roll = percent(rng);
+            int k = key(rng);
+            if (roll < 40) {
+                reference.insert(k);
+                line += "I" + std::to_string(k);
+            } else if (roll < 60) {
+                reference.erase(k);
+                line += "R" + std::to_string(k);
+            } else if (roll < 95) {
+                line += (reference.count(k) ? "C" : "D") + std::to_string(k);
+            } else if (roll < 98) {
+                line += "S" + std::to_string(reference.size());
+            } else {
+                line += "L" + std::to_string(roundedLoad(reference.size(), buckets));
+            }
+        }
+        line += "S" + std::to_string(reference.size()) + "X\n";
+        out << line;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = "/tests/tests";
+    bool replay = false;
+    int repeat = 1;
+
+    if (argc > 1 && std::string(argv[1]) == "--generate") {
+        if (argc < 4) {
+            std::cout << "Usage: main --generate TESTS OPS [--keys K] [--buckets B] [--seed S]" << std::endl;
+            return 1;
+        }
+        size_t tests = std::stoul(argv[2]);
+        size_t ops = std::stoul(argv[3]);
+        int keys = 10000, buckets = 1024;
+        uint64_t seed = 42;
+        for (int i = 4; i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            if (arg == "--keys") keys = std::max(1, std::stoi(argv[i + 1]));
+            else if (arg == "--buckets") buckets = std::max(1, std::stoi(argv[i + 1]));
+            else if (arg == "--seed") seed = std::stoull(argv[i + 1]);
+        }
+        generateTrace(std::cout, tests, ops, keys, buckets, seed);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--replay") replay = true;
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::stoi(argv[++i]));
+        else path = arg;
+    }
+
+    // Read the whole test file; comments are skipped by the compiler
+    std::ifstream file(path, std::ios::binary);
     if (!file) {
         std::cout << "Error opening file" << std::endl;
         return 1;
     }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CompiledTests compiled = compileTests(text);
 
-    // Array to store test cases
-    char testCases[TESTS][TEST_LENGTH];
-    int testCount = 0;
+    int failedTests = 0;
 
-    // Read test cases from file, skipping comment lines
-    while (std::fgets(testCases[testCount], TEST_LENGTH, file) && testCount < TESTS) {
-        if (testCases[testCount][0] != '-') { // Skip comment lines
-            char* newline = std::strchr(testCases[testCount], '\n');
-            if (newline) *newline = '\0';  // Remove newline character
-            testCount++;
+    if (replay) {
+        // Time whole passes over the compiled tests; results are checked on every pass
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            failedTests = 0;
+            for (const TestRange& test : compiled.tests) {
+                if (!runTest(compiled.code.data() + test.begin, compiled.code.data() + test.end)) failedTests++;
+            }
         }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double instructions = static_cast<double>(compiled.code.size()) * repeat;
+        std::cout << "Tests: " << compiled.tests.size() << ", instructions: " << compiled.code.size()
+                  << ", passes: " << repeat << std::endl;
+        std::cout << "Time: " << seconds << " s, " << (seconds > 0 ? instructions / seconds : 0)
+                  << " instructions/sec" << std::endl;
+        if (failedTests > 0) std::cout << failedTests << " tests failed" << std::endl;
+        return failedTests;
     }
-    std::fclose(file);
-
-    int failedTests = 0;
 
     // Run all test cases
-    for (int i = 0; i < testCount; i++) {
-        bool testPassed = runTest(testCases[i]);
+    for (size_t i = 0; i < compiled.tests.size(); i++) {
+        const TestRange& test = compiled.tests[i];
+        bool testPassed = runTest(compiled.code.data() + test.begin, compiled.code.data() + test.end);
         if (testPassed) {
             std::cout << "Test " << i + 1 << " passed" << std::endl;
         } else {
@@ -0,0 +1,118 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "histogram.hpp"
+
+// Server counters and latency histograms.
+//
+// Everything here is updated with relaxed atomic increments so recording is
+// lock-free and safe from any number of request threads. Snapshots read
+// each counter once and are not a consistent cut across counters, which is
+// fine for a scraper polling totals.
+
+// Nanoseconds on the monotonic clock
+inline uint64_t metricsNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Lock-free version of LatencyHistogram, with the same buckets
+class AtomicHistogram {
+private:
+    std::atomic<uint64_t> counts[histogram::BUCKET_COUNT];
+    std::atomic<uint64_t> sums[histogram::BUCKET_COUNT];
+
+public:
+    AtomicHistogram() {
+        for (int i = 0; i < histogram::BUCKET_COUNT; i++) {
+            counts[i].store(0, std::memory_order_relaxed);
+            sums[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    AtomicHistogram(const AtomicHistogram&) = delete;
+    AtomicHistogram& operator=(const AtomicHistogram&) = delete;
+
+    void record(uint64_t value) {
+        int index = histogram::bucketIndex(value);
+        counts[index].fetch_add(1, std::memory_order_relaxed);
+        sums[index].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // Copy the current counts into a plain histogram for reporting
+    LatencyHistogram snapshot() const {
+        LatencyHistogram copy;
+        for (int i = 0; i < histogram::BUCKET_COUNT; i++) {
+            uint64_t count = counts[i].load(std::memory_order_relaxed);
+            if (count > 0) copy.addBucket(i, count, sums[i].load(std::memory_order_relaxed));
+        }
+        return copy;
+    }
+};
+
+struct ServerMetrics {
+    // Requests by message type
+    std::atomic<uint64_t> file_requests{0};
+    std::atomic<uint64_t> get_requests{0};
+    std::atomic<uint64_t> stats_requests{0};
+    std::atomic<uint64_t> batch_requests{0};
+    std::atomic<uint64_t> batch_files{0};  // Files stored through BATCH messages
+    std::atomic<uint64_t> unknown_requests{0};
+
+    // Outcomes
+    std::atomic<uint64_t> not_found{0};
+    std::atomic<uint64_t> errors{0};  // Malformed messages and failed sends/receives
+
+    std::atomic<uint64_t> bytes_in{0};   // Message bodies received, excluding the length prefix
+    std::atomic<uint64_t> bytes_out{0};  // Replies sent, excluding the length prefix
+
+    // Stage latencies in nanoseconds
+    AtomicHistogram deserialize_ns;
+    AtomicHistogram lookup_ns;     // HashMap insert or find
+    AtomicHistogram serialize_ns;
+    AtomicHistogram send_ns;
+    AtomicHistogram persist_ns;
+
+    // Render as "name value" lines; store_size and store_buckets describe the
+    // HashMap, which the caller reads under whatever lock guards it
+    std::string render(size_t store_size, size_t store_buckets) const {
+        std::ostringstream out;
+        out << "requests_file " << file_requests.load(std::memory_order_relaxed) << "\n";
+        out << "requests_get " << get_requests.load(std::memory_order_relaxed) << "\n";
+        out << "requests_stats " << stats_requests.load(std::memory_order_relaxed) << "\n";
+        out << "requests_batch " << batch_requests.load(std::memory_order_relaxed) << "\n";
+        out << "batch_files " << batch_files.load(std::memory_order_relaxed) << "\n";
+        out << "requests_unknown " << unknown_requests.load(std::memory_order_relaxed) << "\n";
+        out << "responses_not_found " << not_found.load(std::memory_order_relaxed) << "\n";
+        out << "errors " << errors.load(std::memory_order_relaxed) << "\n";
+        out << "bytes_in " << bytes_in.load(std::memory_order_relaxed) << "\n";
+        out << "bytes_out " << bytes_out.load(std::memory_order_relaxed) << "\n";
+        out << "store_files " << store_size << "\n";
+        out << "store_buckets " << store_buckets << "\n";
+        out << "store_load_factor " << (store_buckets == 0 ? 0.0 : static_cast<double>(store_size) / store_buckets) << "\n";
+        renderHistogram(out, "deserialize_ns", deserialize_ns);
+        renderHistogram(out, "lookup_ns", lookup_ns);
+        renderHistogram(out, "serialize_ns", serialize_ns);
+        renderHistogram(out, "send_ns", send_ns);
+        renderHistogram(out, "persist_ns", persist_ns);
+        return out.str();
+    }
+
+private:
+    static void renderHistogram(std::ostringstream& out, const char* name, const AtomicHistogram& hist) {
+        LatencyHistogram h = hist.snapshot();
+        out << name << "_count " << h.count() << "\n";
+        out << name << "_mean " << static_cast<uint64_t>(h.mean()) << "\n";
+        out << name << "_p50 " << h.percentile(50) << "\n";
+        out << name << "_p99 " << h.percentile(99) << "\n";
+        out << name << "_p999 " << h.percentile(99.9) << "\n";
+        out << name << "_max " << h.max() << "\n";
+    }
+};
+
+#endif // METRICS_HPP
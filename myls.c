@@ -5,6 +5,11 @@
 #include <string.h>
 #include <unistd.h> //access()
 #include <sys/stat.h> //needed to find the bytes of the file for show_directory_long and show_directory_long_all
+#include <fcntl.h> //fstatat()/faccessat() relative to the directory fd
+#include <errno.h>
+#include <pthread.h> //parallel stat in show_directory_long_threads
+#include <stdatomic.h>
+#include "myls.h"
 
 //Four functions are called here, each serving a purpose that is described in my_ls.h
 //directory is the common parameter here when passing the argument into the main function
@@ -65,11 +70,109 @@ void show_directory_all(char *directory) {
     closedir(dirp);
 }
 
-// Function to display the contents of the directory with detailed information (non-hidden files only)
-void show_directory_long(char* directory) {
+// One directory entry read by read_entries(); names live in a shared arena so
+// huge directories cost one allocation per growth step, not one per entry
+typedef struct {
+    size_t name_offset;   // Offset of the name in the arena
+    unsigned char d_type; // From readdir, DT_UNKNOWN on filesystems that don't fill it in
+    int stat_error;       // 0 when st is valid, else the errno from fstatat
+    int executable;       // faccessat(X_OK) succeeded
+    struct stat st;
+} ListEntry;
+
+typedef struct {
+    ListEntry* entries;
+    size_t count;
+    size_t capacity;
+    char* names;
+    size_t names_used;
+    size_t names_capacity;
+    int dir_fd;           // Entries are stat'ed relative to this, so no path building
+} EntryList;
+
+// Read every entry of dirp once into list, skipping . and .. and, unless
+// include_hidden is set, names starting with '.'. Returns 0 on success.
+static int read_entries(DIR* dirp, int include_hidden, EntryList* list) {
+    struct dirent* entry;
+    while ((entry = readdir(dirp)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        if (!include_hidden && entry->d_name[0] == '.') {
+            continue;
+        }
+        size_t name_len = strlen(entry->d_name) + 1;
+        if (list->names_used + name_len > list->names_capacity) {
+            size_t capacity = list->names_capacity ? list->names_capacity * 2 : 4096;
+            while (capacity < list->names_used + name_len) {
+                capacity *= 2;
+            }
+            char* names = realloc(list->names, capacity);
+            if (!names) {
+                return 1;
+            }
+            list->names = names;
+            list->names_capacity = capacity;
+        }
+        if (list->count == list->capacity) {
+            size_t capacity = list->capacity ? list->capacity * 2 : 256;
+            ListEntry* entries = realloc(list->entries, capacity * sizeof(ListEntry));
+            if (!entries) {
+                return 1;
+            }
+            list->entries = entries;
+            list->capacity = capacity;
+        }
+        ListEntry* item = &list->entries[list->count++];
+        item->name_offset = list->names_used;
+        item->d_type = entry->d_type;
+        memcpy(list->names + list->names_used, entry->d_name, name_len);
+        list->names_used += name_len;
+    }
+    return 0;
+}
+
+// stat and access-check entries [begin, end) relative to the directory fd
+static void stat_entries(EntryList* list, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        ListEntry* item = &list->entries[i];
+        const char* name = list->names + item->name_offset;
+        //follows symlinks like stat() and access() on the full path did
+        item->stat_error = fstatat(list->dir_fd, name, &item->st, 0) == 0 ? 0 : errno;
+        if (item->d_type == DT_UNKNOWN && item->stat_error == 0) {
+            item->d_type = S_ISDIR(item->st.st_mode) ? DT_DIR : DT_REG;
+        }
+        //directories get '/' instead, so they skip the access check
+        item->executable = item->stat_error == 0 && item->d_type != DT_DIR &&
+                           faccessat(list->dir_fd, name, X_OK, 0) == 0;
+    }
+}
+
+#define STAT_CHUNK 256 // Entries a stat thread claims at a time
+
+typedef struct {
+    EntryList* list;
+    atomic_size_t next; // Next unclaimed entry
+} StatWork;
+
+static void* stat_worker(void* arg) {
+    StatWork* work = arg;
+    size_t count = work->list->count;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&work->next, STAT_CHUNK);
+        if (begin >= count) {
+            return NULL;
+        }
+        size_t end = begin + STAT_CHUNK < count ? begin + STAT_CHUNK : count;
+        stat_entries(work->list, begin, end);
+    }
+}
+
+// Function to display the contents of the directory with detailed information.
+// The directory is read once into a buffer; entries are then stat'ed relative to
+// the directory fd, split across up to threads threads when there are enough of them.
+void show_directory_long_threads(char* directory, int include_hidden, int threads) {
     DIR *dirp;
-    struct dirent *entry;
-    struct stat file_size;
     int count_inFile = 0;  // Initialize count for files
     int count_inDir = 0;   // Initialize count for directories
 
@@ -79,120 +182,402 @@ void show_directory_long(char* directory) {
         return;
     }
 
-    // First, count the number of files and directories in the directory
-    while ((entry = readdir(dirp)) != NULL) {
-        // Skip hidden files (files that start with a dot)
-        if (entry->d_name[0] == '.') {
-            continue;  // Skip hidden files
+    EntryList list = {0};
+    list.dir_fd = dirfd(dirp);
+    if (read_entries(dirp, include_hidden, &list) != 0) {
+        perror("error");
+        free(list.entries);
+        free(list.names);
+        closedir(dirp);
+        return;
+    }
+
+    if (threads > 1 && list.count > STAT_CHUNK) {
+        //stat is mostly waiting on the filesystem, so several in flight overlap that latency
+        StatWork work;
+        work.list = &list;
+        atomic_init(&work.next, 0);
+        pthread_t* workers = malloc((size_t)threads * sizeof(pthread_t));
+        int started = 0;
+        while (workers && started < threads && pthread_create(&workers[started], NULL, stat_worker, &work) == 0) {
+            started++;
+        }
+        stat_worker(&work); //this thread helps, and finishes the job alone if no thread started
+        for (int i = 0; i < started; i++) {
+            pthread_join(workers[i], NULL);
         }
+        free(workers);
+    } else {
+        stat_entries(&list, 0, list.count);
+    }
 
-        // If the entry is a directory, increment the directory counter
-        if (entry->d_type == DT_DIR) {//source cited adn followed under the struct dirent
-            count_inDir++;  // Increment directory count
+    // Count the files and directories from the buffered entries
+    for (size_t i = 0; i < list.count; i++) {
+        if (list.entries[i].d_type == DT_DIR) {
+            count_inDir++;
         } else {
-            count_inFile++;  // Otherwise, it's a file, so increment the file count
+            count_inFile++;
         }
     }
 
-    // Rewind the directory stream to read entries again
-    rewinddir(dirp);
-
     // Print the total count of files and directories
-    printf("Total files: %d\n", count_inFile);  // Display the count of files
-    printf("Total directories: %d\n", count_inDir);  // Display the count of directories
+    printf("Total files: %d\n", count_inFile);
+    printf("Total directories: %d\n", count_inDir);
 
-    // Read and print the directory entries (excluding hidden files)
-    while ((entry = readdir(dirp)) != NULL) {
-        if (entry->d_name[0] != '.') {  // Skip hidden files (files that start with a dot)
-            char full_path[512];  // a buffer for storing the full path of the entry
-            snprintf(full_path, sizeof(full_path), "%s/%s", directory, entry->d_name);  // Create the full path
-
-            // Get file information using stat()
-            if (stat(full_path, &file_size) == 0) {// this format followed using a source cited below
-                printf("%s", entry->d_name);  // Print the name of the directory or file
-
-                // Check if the entry is a directory or executable
-                if (entry->d_type == DT_DIR) {
-                    printf("/");  // Mark directories with '/'
-                } else if (access(full_path, X_OK) == 0) {  // If the entry is executable
-                    printf("*");  // Mark the executable with '*'
-                }
-
-                printf(" (%d bytes)\n", file_size.st_size);  // Print the file size
-            } else {
-                perror("error"); // Print error message if stat fails
-                printf("%s\n", entry->d_name); // Just print the file name if stat fails
+    // Print the entries in directory order
+    for (size_t i = 0; i < list.count; i++) {
+        ListEntry* item = &list.entries[i];
+        const char* name = list.names + item->name_offset;
+        if (item->stat_error == 0) {
+            printf("%s", name);  // Print the name of the directory or file
+
+            // Check if the entry is a directory or executable
+            if (item->d_type == DT_DIR) {
+                printf("/");  // Mark directories with '/'
+            } else if (item->executable) {
+                printf("*");  // Mark the executable with '*'
             }
+
+            printf(" (%lld bytes)\n", (long long)item->st.st_size);  // off_t is 64-bit; %d truncated large files
+        } else {
+            fprintf(stderr, "error: %s\n", strerror(item->stat_error)); // same message perror() gave
+            printf("%s\n", name); // Just print the file name if stat fails
         }
     }
+
+    free(list.entries);
+    free(list.names);
     // Close the directory stream at the end
-    closedir(dirp); 
+    closedir(dirp);
+}
+
+// Function to display the contents of the directory with detailed information (non-hidden files only)
+void show_directory_long(char* directory) {
+    show_directory_long_threads(directory, 0, 1);
 }
- 
+
 void show_directory_long_all(char* directory){
-    //alot of the code below is similar to the one above, except we are including hidden files 
-    DIR *dirp;
-    struct dirent *entry;
-    struct stat file_size; //custom data type that holds info about the file, including the size, file_size is the pointer
-    int count_inFile = 0;
-    int count_inDir = 0;
+    //same listing as above, except we are including hidden files
+    show_directory_long_threads(directory, 1, 1);
+}
 
-    // Open the directory
-    if ((dirp = opendir(directory)) == NULL) {
-        perror("error");
-        return;
+// A directory in the walk. It lives from the moment it is queued until its
+// whole subtree is done, so memory follows the walk frontier, not the tree.
+typedef struct WalkDir {
+    struct WalkDir* parent;
+    char* path;
+    atomic_int pending;            // Its own scan plus each unfinished subdirectory
+    atomic_llong child_files;      // Totals reported by finished subdirectories
+    atomic_llong child_bytes;
+    atomic_llong child_dirs;
+    long long files;
+    long long bytes;
+    long long subdirs;
+    int error;
+} WalkDir;
+
+// One thread's queue. The owner pushes and pops at the end (depth first, keeps
+// the frontier small); idle threads steal from the front, which holds the
+// shallowest and so usually the biggest subtrees.
+typedef struct {
+    pthread_mutex_t lock;
+    WalkDir** items;
+    size_t head;
+    size_t count;
+    size_t capacity;
+} WalkQueue;
+
+typedef struct {
+    WalkQueue* queues;
+    int threads;
+    int include_hidden;
+    const WalkVisitor* visitor;
+    atomic_long queued;            // Directories sitting in queues
+    atomic_long outstanding;       // Directories queued or being scanned; 0 ends the walk
+    atomic_int idle;               // Threads waiting on wake
+    atomic_int failed;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t wake;
+    pthread_mutex_t visit_lock;    // Serializes directory_done
+} Walk;
+
+typedef struct {
+    Walk* walk;
+    int id;
+} WalkWorker;
+
+static WalkDir* new_walk_dir(WalkDir* parent, const char* path, const char* name) {
+    WalkDir* dir = calloc(1, sizeof(WalkDir));
+    if (!dir) {
+        return NULL;
     }
+    size_t path_len = strlen(path);
+    size_t name_len = name ? strlen(name) : 0;
+    dir->path = malloc(path_len + name_len + 2);
+    if (!dir->path) {
+        free(dir);
+        return NULL;
+    }
+    memcpy(dir->path, path, path_len);
+    if (name) {
+        dir->path[path_len] = '/';
+        memcpy(dir->path + path_len + 1, name, name_len + 1);
+    } else {
+        dir->path[path_len] = '\0';
+    }
+    dir->parent = parent;
+    atomic_init(&dir->pending, 1);
+    atomic_init(&dir->child_files, 0);
+    atomic_init(&dir->child_bytes, 0);
+    atomic_init(&dir->child_dirs, 0);
+    return dir;
+}
 
-    // First, count the number of files and folders in the directory
-    while ((entry = readdir(dirp)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;  // Skip current (.) and parent (..) directory entries
+static int push_walk_dir(Walk* walk, int id, WalkDir* dir) {
+    WalkQueue* queue = &walk->queues[id];
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head + queue->count == queue->capacity) {
+        if (queue->head > 0) {
+            //slide the live items back to the front before growing
+            memmove(queue->items, queue->items + queue->head, queue->count * sizeof(WalkDir*));
+            queue->head = 0;
         }
-    //When running the code, the output displayed . and .. to indicate such files existed but this portion is redundant in the process
-
-        if (entry->d_type == DT_DIR) { // Directory
-            count_inDir++;
-        } else {  // Regular file
-            count_inFile++;
+        if (queue->count == queue->capacity) {
+            size_t capacity = queue->capacity ? queue->capacity * 2 : 64;
+            WalkDir** items = realloc(queue->items, capacity * sizeof(WalkDir*));
+            if (!items) {
+                pthread_mutex_unlock(&queue->lock);
+                return 1;
+            }
+            queue->items = items;
+            queue->capacity = capacity;
         }
     }
+    queue->items[queue->head + queue->count++] = dir;
+    pthread_mutex_unlock(&queue->lock);
+
+    atomic_fetch_add(&walk->queued, 1);
+    if (atomic_load(&walk->idle) > 0) {
+        pthread_mutex_lock(&walk->wake_lock);
+        pthread_cond_signal(&walk->wake);
+        pthread_mutex_unlock(&walk->wake_lock);
+    }
+    return 0;
+}
 
-    // Rewind the directory stream to read entries again
-    rewinddir(dirp); // Needed to loop through it again to print the details
+// Pop from our own queue's end, else steal from the front of another's
+static WalkDir* take_walk_dir(Walk* walk, int id) {
+    for (int i = 0; i < walk->threads; i++) {
+        int victim = (id + i) % walk->threads;
+        WalkQueue* queue = &walk->queues[victim];
+        WalkDir* dir = NULL;
+        pthread_mutex_lock(&queue->lock);
+        if (queue->count > 0) {
+            if (victim == id) {
+                dir = queue->items[queue->head + --queue->count];
+            } else {
+                dir = queue->items[queue->head++];
+                queue->count--;
+            }
+            if (queue->count == 0) {
+                queue->head = 0;
+            }
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if (dir) {
+            atomic_fetch_sub(&walk->queued, 1);
+            return dir;
+        }
+    }
+    return NULL;
+}
 
-    // Print counts for files and directories
-    printf("Total files: %d\n", count_inFile);   // Print total count of files
-    printf("Total directories: %d\n", count_inDir); // Print total count of directories
+// Drop one pending count; whoever drops a directory's last one reports it and
+// passes its totals up, possibly finishing the parent in turn
+static void finish_walk_dir(Walk* walk, WalkDir* dir) {
+    while (dir != NULL && atomic_fetch_sub(&dir->pending, 1) == 1) {
+        DirSummary summary;
+        summary.path = dir->path;
+        summary.error = dir->error;
+        summary.files = dir->files;
+        summary.bytes = dir->bytes;
+        summary.subdirs = dir->subdirs;
+        summary.total_files = dir->files + atomic_load(&dir->child_files);
+        summary.total_bytes = dir->bytes + atomic_load(&dir->child_bytes);
+        summary.total_dirs = dir->subdirs + atomic_load(&dir->child_dirs);
+        if (walk->visitor->directory_done) {
+            pthread_mutex_lock(&walk->visit_lock);
+            walk->visitor->directory_done(&summary, walk->visitor->context);
+            pthread_mutex_unlock(&walk->visit_lock);
+        }
+        WalkDir* parent = dir->parent;
+        if (parent) {
+            atomic_fetch_add(&parent->child_files, summary.total_files);
+            atomic_fetch_add(&parent->child_bytes, summary.total_bytes);
+            atomic_fetch_add(&parent->child_dirs, summary.total_dirs);
+        }
+        free(dir->path);
+        free(dir);
+        dir = parent;
+    }
+}
 
-    // Read and print the directory entries (including hidden files)
+// Read one directory: count and size its files, queue its subdirectories
+static void scan_walk_dir(Walk* walk, int id, WalkDir* dir) {
+    DIR* dirp = opendir(dir->path);
+    if (!dirp) {
+        dir->error = errno;
+        atomic_store(&walk->failed, 1);
+        finish_walk_dir(walk, dir);
+        return;
+    }
+    int fd = dirfd(dirp);
+    struct dirent* entry;
+    struct stat st;
     while ((entry = readdir(dirp)) != NULL) {
-        // Skip . and .. entries
         if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
             continue;
-        }//had to declare this since it didn't work the first time as it outputted twice in a row
-        
-        // Construct the full path to the entry by combining the directory path and entry name
-        char full_path[512];//buffer
-        snprintf(full_path, sizeof(full_path), "%s/%s", directory, entry->d_name);  // Full path
-
-        // Get file information using stat()
-            if (stat(full_path, &file_size) == 0) {// this format followed using a source cited below
-                printf("%s", entry->d_name);  // Print the name of the directory or file
-
-                // Check if the entry is a directory or executable
-                if (entry->d_type == DT_DIR) {
-                    printf("/");  // Mark directories with '/'
-                } else if (access(full_path, X_OK) == 0) {  // If the entry is executable
-                    printf("*");  // Mark the executable with '*'
-                }
-
-                printf(" (%d bytes)\n", file_size.st_size);  // Print the file size
-            } else {
-                perror("error"); // Print error message if stat fails
-                printf("%s\n", entry->d_name); // Just print the file name if stat fails
+        }
+        if (!walk->include_hidden && entry->d_name[0] == '.') {
+            continue;
+        }
+        int is_dir = entry->d_type == DT_DIR;
+        //directories are only sized by their contents, so d_type saves their stat call
+        if (!is_dir) {
+            if (fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue; //removed since readdir
+            }
+            is_dir = S_ISDIR(st.st_mode);
+        }
+        if (is_dir) {
+            dir->subdirs++;
+            WalkDir* child = new_walk_dir(dir, dir->path, entry->d_name);
+            if (!child) {
+                atomic_store(&walk->failed, 1);
+                continue;
+            }
+            atomic_fetch_add(&dir->pending, 1);
+            atomic_fetch_add(&walk->outstanding, 1);
+            if (push_walk_dir(walk, id, child) != 0) {
+                //no room to queue it: scan it right here instead
+                atomic_fetch_sub(&walk->outstanding, 1);
+                scan_walk_dir(walk, id, child);
+            }
+        } else {
+            dir->files++;
+            dir->bytes += st.st_size;
+            if (walk->visitor->file) {
+                walk->visitor->file(dir->path, entry->d_name, &st, walk->visitor->context);
             }
+        }
     }
-    // Close the directory stream at the end
-    closedir(dirp);   
+    closedir(dirp);
+    finish_walk_dir(walk, dir);
+}
+
+static void* walk_worker(void* arg) {
+    WalkWorker* worker = arg;
+    Walk* walk = worker->walk;
+    for (;;) {
+        WalkDir* dir = take_walk_dir(walk, worker->id);
+        if (dir) {
+            scan_walk_dir(walk, worker->id, dir);
+            if (atomic_fetch_sub(&walk->outstanding, 1) == 1) {
+                //that was the last directory: wake everyone so they can exit
+                pthread_mutex_lock(&walk->wake_lock);
+                pthread_cond_broadcast(&walk->wake);
+                pthread_mutex_unlock(&walk->wake_lock);
+            }
+            continue;
+        }
+        pthread_mutex_lock(&walk->wake_lock);
+        atomic_fetch_add(&walk->idle, 1);
+        while (atomic_load(&walk->queued) == 0 && atomic_load(&walk->outstanding) > 0) {
+            pthread_cond_wait(&walk->wake, &walk->wake_lock);
+        }
+        atomic_fetch_sub(&walk->idle, 1);
+        int done = atomic_load(&walk->outstanding) == 0;
+        pthread_mutex_unlock(&walk->wake_lock);
+        if (done) {
+            return NULL;
+        }
+    }
+}
+
+int walk_directory(const char* root, int include_hidden, int threads, const WalkVisitor* visitor) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    Walk walk;
+    walk.threads = threads;
+    walk.include_hidden = include_hidden;
+    walk.visitor = visitor;
+    atomic_init(&walk.queued, 0);
+    atomic_init(&walk.outstanding, 1);
+    atomic_init(&walk.idle, 0);
+    atomic_init(&walk.failed, 0);
+    pthread_mutex_init(&walk.wake_lock, NULL);
+    pthread_cond_init(&walk.wake, NULL);
+    pthread_mutex_init(&walk.visit_lock, NULL);
+    walk.queues = calloc(threads, sizeof(WalkQueue));
+    WalkWorker* workers = calloc(threads, sizeof(WalkWorker));
+    pthread_t* ids = calloc(threads, sizeof(pthread_t));
+    WalkDir* top = new_walk_dir(NULL, root, NULL);
+    if (!walk.queues || !workers || !ids || !top) {
+        free(walk.queues);
+        free(workers);
+        free(ids);
+        if (top) {
+            free(top->path);
+            free(top);
+        }
+        return 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&walk.queues[i].lock, NULL);
+        workers[i].walk = &walk;
+        workers[i].id = i;
+    }
+    if (push_walk_dir(&walk, 0, top) != 0) {
+        //can't even queue the root: walk the whole tree on this thread
+        scan_walk_dir(&walk, 0, top);
+        atomic_store(&walk.outstanding, 0);
+    }
+
+    //this thread is worker 0; the rest only start if there's more than one
+    int started = 1;
+    while (started < threads && pthread_create(&ids[started], NULL, walk_worker, &workers[started]) == 0) {
+        started++;
+    }
+    walk_worker(&workers[0]);
+    for (int i = 1; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&walk.queues[i].lock);
+        free(walk.queues[i].items);
+    }
+    free(walk.queues);
+    free(workers);
+    free(ids);
+    pthread_mutex_destroy(&walk.wake_lock);
+    pthread_cond_destroy(&walk.wake);
+    pthread_mutex_destroy(&walk.visit_lock);
+    return atomic_load(&walk.failed);
+}
+
+// Prints one line per finished directory for show_directory_usage()
+static void print_usage(const DirSummary* summary, void* context) {
+    (void)context;
+    if (summary->error) {
+        fprintf(stderr, "error: %s: %s\n", summary->path, strerror(summary->error));
+        return;
+    }
+    printf("%lld\t%lld files\t%s\n", summary->total_bytes, summary->total_files, summary->path);
 }
 
+void show_directory_usage(char* directory, int threads) {
+    WalkVisitor visitor = {print_usage, NULL, NULL};
+    walk_directory(directory, 1, threads, &visitor);
+}
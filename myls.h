@@ -3,6 +3,11 @@
 #define MYLS_H
 #include <stdio.h>
 #include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 void show_directory(char* directory);
 //This function lists the files and folders that are only visible
@@ -25,4 +30,45 @@ void show_directory_long_all(char* directory);
 //Prints total number of files and folders, provides details on each item 
 //parameter: directory that's listed
 
+void show_directory_long_threads(char* directory, int include_hidden, int threads);
+//same output as show_directory_long (include_hidden = 0) or show_directory_long_all (include_hidden = 1)
+//reads the directory once into a buffer and stats entries relative to the directory fd
+//threads > 1 splits the stat calls across that many threads; pays off on huge directories
+//parameter: directory that's listed
+
+typedef struct {
+    const char* path;       //directory path, the root as given plus "/name" per level
+    int error;              //errno if the directory couldn't be opened, else 0
+    long long files;        //non-directory entries directly inside
+    long long bytes;        //their apparent sizes (st_size) added up
+    long long subdirs;      //directories directly inside
+    long long total_files;  //the same three for the whole subtree
+    long long total_bytes;
+    long long total_dirs;
+} DirSummary;
+
+typedef struct {
+    //called once per directory after its whole subtree is done, so children come before
+    //parents and the root comes last; calls are serialized, so it needn't be thread-safe
+    void (*directory_done)(const DirSummary* summary, void* context);
+    //called for every non-directory entry from whichever thread scanned it; may be NULL
+    void (*file)(const char* directory, const char* name, const struct stat* st, void* context);
+    void* context;          //passed to both callbacks
+} WalkVisitor;
+
+int walk_directory(const char* root, int include_hidden, int threads, const WalkVisitor* visitor);
+//walks the tree under root on threads threads (work stealing over subdirectories)
+//symlinks are not followed, and a hard-linked file is counted once per name
+//results stream through visitor as directories finish; nothing is buffered per tree
+//returns 0, or 1 if some directory couldn't be opened (its summary has error set)
+
+void show_directory_usage(char* directory, int threads);
+//a fast du: prints the apparent bytes of all files below each directory (directory entries
+//themselves count 0, unlike du -ab), the file count and the path, deepest directories first
+//parameter: directory whose tree is summarized, threads used for the walk
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif //the source for this format is cited
\ No newline at end of file
@@ -32,6 +32,9 @@ typedef std::string string;
 #define PACK109_A16   0xad
 #define PACK109_M8    0xae
 #define PACK109_M16   0xaf
+#define PACK109_S32   0xb0
+#define PACK109_A32   0xb1
+#define PACK109_M32   0xb2
 #define PACK109_STATUS_TAG 0x01 
 
 //kept same-- no changes
@@ -95,6 +98,14 @@ namespace pack109 {
   std::vector<f64> deserialize_vec_f64(vec bytes);
   std::vector<string> deserialize_vec_string(vec bytes);
 
+  // Bulk numeric arrays (same wire format as the array functions above,
+  // encoded/decoded in one pass with SSSE3 byte shuffles when available)
+  vec serialize_bulk(const std::vector<u64>& item);
+  vec serialize_bulk(const std::vector<f64>& item);
+
+  std::vector<u64> deserialize_vec_u64_bulk(const vec& bytes);
+  std::vector<f64> deserialize_vec_f64_bulk(const vec& bytes);
+
   // Maps
   vec serialize(struct Person item);
   struct Person deserialize_person(vec bytes);
@@ -102,6 +113,71 @@ namespace pack109 {
   vec serialize(const std::map<std::string, vec>& m);
   std::map<std::string, vec> deserialize_map_vec_u8(const vec& bytes);
 
+  // Large collections
+  // Headers use the smallest of the 8/16/32-bit length tags that fits, so
+  // strings past 64 KB and arrays/maps past 65535 entries use S32/A32/M32.
+  void append_string_header(vec& out, size_t length);
+  void append_array_header(vec& out, size_t count);
+  void append_map_header(vec& out, size_t count);
+
+  // Return the element/pair count and set header_len to the header size
+  size_t read_array_header(const u8* data, size_t size, size_t& header_len);
+  size_t read_map_header(const u8* data, size_t size, size_t& header_len);
+
+  // Number of bytes taken by the encoded value starting at data.
+  // Array elements are expected to be tagged; the untagged byte arrays
+  // written by serialize(std::vector<u8>) can't be skipped generically.
+  size_t encoded_size(const u8* data, size_t size);
+
+  // Streaming iteration
+  // Non-owning view of one encoded value inside a larger buffer
+  struct Slice {
+    const u8* data;
+    size_t size;
+
+    vec to_vec() const { return vec(data, data + size); }
+  };
+
+  // Decode a string slice tagged S8, S16 or S32
+  string slice_to_string(const Slice& slice);
+
+  // Walks an encoded array one element at a time without decoding the rest.
+  // The underlying buffer must outlive the reader.
+  class ArrayReader {
+  public:
+    explicit ArrayReader(const vec& bytes);
+    ArrayReader(const u8* data, size_t size);
+
+    size_t size() const { return count; }
+    bool next(Slice& element);
+
+  private:
+    const u8* data;
+    size_t length;
+    size_t pos;
+    size_t count;
+    size_t index;
+  };
+
+  // Walks an encoded map one key/value pair at a time
+  class MapReader {
+  public:
+    explicit MapReader(const vec& bytes);
+    MapReader(const u8* data, size_t size);
+
+    size_t size() const { return count; }
+    bool next(Slice& key, Slice& value);
+    // Scan the remaining pairs for key; only the matched value is returned
+    bool find(const string& key, Slice& value);
+
+  private:
+    const u8* data;
+    size_t length;
+    size_t pos;
+    size_t count;
+    size_t index;
+  };
+
 }
 
 #endif
@@ -0,0 +1,131 @@
+#include <cstring>
+#include <stdexcept>
+#include "pack109.hpp"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+// Bulk encoders for homogeneous u64/f64 arrays.
+// Output is byte-for-byte identical to serialize(std::vector<u64>) and
+// serialize(std::vector<f64>): an A8/A16/A32 header followed by one
+// tagged, big-endian 9 byte element per item. The difference is that the whole
+// output is sized once up front and the byte swapping is done in bulk.
+
+namespace {
+
+  const size_t ELEMENT_SIZE = 9;  // 1 tag byte + 8 payload bytes
+
+  inline u64 load_be64(const u8* p) {
+    u64 word;
+    std::memcpy(&word, p, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+  }
+
+  inline void store_tagged_be64(u8* out, u8 tag, u64 word) {
+    out[0] = tag;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    std::memcpy(out + 1, &word, sizeof(word));
+  }
+
+  // Encode count 8 byte words from src into tagged big-endian elements
+  void encode_words(const u64* src, size_t count, u8 tag, u8* out) {
+    size_t i = 0;
+#if defined(__SSSE3__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Two words (16 bytes) become two elements (18 bytes). One shuffle
+    // reverses both words into place and leaves holes for the tags; the
+    // last two bytes of the second element don't fit in the 16 byte
+    // register and are written separately.
+    const __m128i shuffle = _mm_setr_epi8(
+        -1, 7, 6, 5, 4, 3, 2, 1, 0, -1, 15, 14, 13, 12, 11, 10);
+    const __m128i tags = _mm_setr_epi8(
+        static_cast<char>(tag), 0, 0, 0, 0, 0, 0, 0, 0,
+        static_cast<char>(tag), 0, 0, 0, 0, 0, 0);
+    for (; i + 2 <= count; i += 2) {
+      __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      __m128i packed = _mm_or_si128(_mm_shuffle_epi8(words, shuffle), tags);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+      const u8* raw = reinterpret_cast<const u8*>(src + i);
+      out[16] = raw[9];
+      out[17] = raw[8];
+      out += 2 * ELEMENT_SIZE;
+    }
+#endif
+    for (; i < count; i++) {
+      store_tagged_be64(out, tag, src[i]);
+      out += ELEMENT_SIZE;
+    }
+  }
+
+  // Read the array header and make sure all count elements are present,
+  // before anything is allocated for them
+  size_t read_checked_header(const vec& bytes, size_t& header_len) {
+    size_t count = pack109::read_array_header(bytes.data(), bytes.size(), header_len);
+    if ((bytes.size() - header_len) / ELEMENT_SIZE < count) {
+      throw std::runtime_error("pack109: array truncated");
+    }
+    return count;
+  }
+
+  // Validate every element tag in one pass, then decode without branches
+  void decode_words(const vec& bytes, u8 tag, u64* dst, size_t count, size_t header_len) {
+    const u8* in = bytes.data() + header_len;
+
+    u8 mismatch = 0;
+    for (size_t i = 0; i < count; i++) {
+      mismatch |= in[i * ELEMENT_SIZE] ^ tag;
+    }
+    if (mismatch != 0) {
+      throw std::runtime_error("pack109: unexpected element tag in array");
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      dst[i] = load_be64(in + i * ELEMENT_SIZE + 1);
+    }
+  }
+
+  vec serialize_words(const u64* src, size_t count, u8 tag) {
+    vec bytes;
+    bytes.reserve(5 + count * ELEMENT_SIZE);
+    pack109::append_array_header(bytes, count);
+    size_t header_len = bytes.size();
+    bytes.resize(header_len + count * ELEMENT_SIZE);
+    encode_words(src, count, tag, bytes.data() + header_len);
+    return bytes;
+  }
+
+}
+
+namespace pack109 {
+
+  vec serialize_bulk(const std::vector<u64>& item) {
+    return serialize_words(item.data(), item.size(), PACK109_U64);
+  }
+
+  vec serialize_bulk(const std::vector<f64>& item) {
+    static_assert(sizeof(f64) == sizeof(u64), "f64 must be 8 bytes");
+    return serialize_words(reinterpret_cast<const u64*>(item.data()), item.size(), PACK109_F64);
+  }
+
+  std::vector<u64> deserialize_vec_u64_bulk(const vec& bytes) {
+    size_t header_len = 0;
+    size_t count = read_checked_header(bytes, header_len);
+    std::vector<u64> result(count);
+    decode_words(bytes, PACK109_U64, result.data(), count, header_len);
+    return result;
+  }
+
+  std::vector<f64> deserialize_vec_f64_bulk(const vec& bytes) {
+    size_t header_len = 0;
+    size_t count = read_checked_header(bytes, header_len);
+    std::vector<f64> result(count);
+    decode_words(bytes, PACK109_F64, reinterpret_cast<u64*>(result.data()), count, header_len);
+    return result;
+  }
+
+}
@@ -0,0 +1,204 @@
+#include <cstring>
+#include <stdexcept>
+#include "pack109.hpp"
+
+// Length headers for large strings/arrays/maps (S32/A32/M32) and lazy,
+// forward-only readers that walk an encoded array or map in place.
+
+namespace {
+
+  const int MAX_NESTING = 64;  // Guards encoded_size() against hostile input
+
+  void append_be(vec& out, size_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+      out.push_back(static_cast<u8>(value >> shift));
+    }
+  }
+
+  size_t read_be(const u8* data, int bytes) {
+    size_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+      value = (value << 8) | data[i];
+    }
+    return value;
+  }
+
+  void append_header(vec& out, size_t length, u8 tag8, u8 tag16, u8 tag32) {
+    if (length <= 0xff) {
+      out.push_back(tag8);
+      append_be(out, length, 1);
+    } else if (length <= 0xffff) {
+      out.push_back(tag16);
+      append_be(out, length, 2);
+    } else if (length <= 0xffffffffUL) {
+      out.push_back(tag32);
+      append_be(out, length, 4);
+    } else {
+      throw std::length_error("pack109: collection too long to serialize");
+    }
+  }
+
+  // Width of the length field for an 8/16/32-bit tag triple, 0 if no match
+  int header_width(u8 tag, u8 tag8, u8 tag16, u8 tag32) {
+    if (tag == tag8) return 1;
+    if (tag == tag16) return 2;
+    if (tag == tag32) return 4;
+    return 0;
+  }
+
+  size_t read_header(const u8* data, size_t size, size_t& header_len,
+                     u8 tag8, u8 tag16, u8 tag32, const char* what) {
+    int width = size > 0 ? header_width(data[0], tag8, tag16, tag32) : 0;
+    if (width == 0) {
+      throw std::runtime_error(std::string("pack109: expected ") + what);
+    }
+    if (size < 1 + static_cast<size_t>(width)) {
+      throw std::runtime_error(std::string("pack109: truncated ") + what + " header");
+    }
+    header_len = 1 + width;
+    return read_be(data + 1, width);
+  }
+
+  size_t value_size(const u8* data, size_t size, int depth);
+
+  // Size of count consecutive values starting at data
+  size_t values_size(const u8* data, size_t size, size_t count, int depth) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+      total += value_size(data + total, size - total, depth);
+    }
+    return total;
+  }
+
+  size_t value_size(const u8* data, size_t size, int depth) {
+    if (size == 0) throw std::runtime_error("pack109: unexpected end of input");
+    if (depth > MAX_NESTING) throw std::runtime_error("pack109: nesting too deep");
+
+    size_t header_len = 0;
+    size_t total = 0;
+    switch (data[0]) {
+      case PACK109_TRUE: case PACK109_FALSE:
+        total = 1; break;
+      case PACK109_U8: case PACK109_I8:
+        total = 2; break;
+      case PACK109_U32: case PACK109_I32: case PACK109_F32:
+        total = 5; break;
+      case PACK109_U64: case PACK109_I64: case PACK109_F64:
+        total = 9; break;
+      case PACK109_S8: case PACK109_S16: case PACK109_S32: {
+        size_t length = read_header(data, size, header_len,
+                                    PACK109_S8, PACK109_S16, PACK109_S32, "string");
+        total = header_len + length;
+        break;
+      }
+      case PACK109_A8: case PACK109_A16: case PACK109_A32: {
+        size_t count = pack109::read_array_header(data, size, header_len);
+        total = header_len + values_size(data + header_len, size - header_len, count, depth + 1);
+        break;
+      }
+      case PACK109_M8: case PACK109_M16: case PACK109_M32: {
+        size_t count = pack109::read_map_header(data, size, header_len);
+        total = header_len + values_size(data + header_len, size - header_len, count * 2, depth + 1);
+        break;
+      }
+      default:
+        throw std::runtime_error("pack109: unknown tag");
+    }
+    if (total > size) throw std::runtime_error("pack109: value truncated");
+    return total;
+  }
+
+}
+
+namespace pack109 {
+
+  void append_string_header(vec& out, size_t length) {
+    append_header(out, length, PACK109_S8, PACK109_S16, PACK109_S32);
+  }
+
+  void append_array_header(vec& out, size_t count) {
+    append_header(out, count, PACK109_A8, PACK109_A16, PACK109_A32);
+  }
+
+  void append_map_header(vec& out, size_t count) {
+    append_header(out, count, PACK109_M8, PACK109_M16, PACK109_M32);
+  }
+
+  size_t read_array_header(const u8* data, size_t size, size_t& header_len) {
+    return read_header(data, size, header_len, PACK109_A8, PACK109_A16, PACK109_A32, "array");
+  }
+
+  size_t read_map_header(const u8* data, size_t size, size_t& header_len) {
+    return read_header(data, size, header_len, PACK109_M8, PACK109_M16, PACK109_M32, "map");
+  }
+
+  size_t encoded_size(const u8* data, size_t size) {
+    return value_size(data, size, 0);
+  }
+
+  string slice_to_string(const Slice& slice) {
+    size_t header_len = 0;
+    size_t length = read_header(slice.data, slice.size, header_len,
+                                PACK109_S8, PACK109_S16, PACK109_S32, "string");
+    if (header_len + length > slice.size) {
+      throw std::runtime_error("pack109: string truncated");
+    }
+    return string(reinterpret_cast<const char*>(slice.data) + header_len, length);
+  }
+
+  // ArrayReader
+
+  ArrayReader::ArrayReader(const vec& bytes) : ArrayReader(bytes.data(), bytes.size()) {}
+
+  ArrayReader::ArrayReader(const u8* data, size_t size)
+      : data(data), length(size), pos(0), count(0), index(0) {
+    count = read_array_header(data, size, pos);
+  }
+
+  bool ArrayReader::next(Slice& element) {
+    if (index >= count) return false;
+    size_t element_size = encoded_size(data + pos, length - pos);
+    element.data = data + pos;
+    element.size = element_size;
+    pos += element_size;
+    index++;
+    return true;
+  }
+
+  // MapReader
+
+  MapReader::MapReader(const vec& bytes) : MapReader(bytes.data(), bytes.size()) {}
+
+  MapReader::MapReader(const u8* data, size_t size)
+      : data(data), length(size), pos(0), count(0), index(0) {
+    count = read_map_header(data, size, pos);
+  }
+
+  bool MapReader::next(Slice& key, Slice& value) {
+    if (index >= count) return false;
+    key.data = data + pos;
+    key.size = encoded_size(key.data, length - pos);
+    pos += key.size;
+    value.data = data + pos;
+    value.size = encoded_size(value.data, length - pos);
+    pos += value.size;
+    index++;
+    return true;
+  }
+
+  bool MapReader::find(const string& key, Slice& value) {
+    Slice current_key;
+    while (next(current_key, value)) {
+      // Compare the encoded key in place instead of building a string
+      size_t header_len = 0;
+      size_t key_length = read_header(current_key.data, current_key.size, header_len,
+                                      PACK109_S8, PACK109_S16, PACK109_S32, "string key");
+      if (key_length == key.size() &&
+          std::memcmp(current_key.data + header_len, key.data(), key_length) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+}
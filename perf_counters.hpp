@@ -0,0 +1,158 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counter totals for one measured region
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+    uint64_t tlb_misses = 0;
+
+    PerfSample& operator+=(const PerfSample& other) {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        cache_misses += other.cache_misses;
+        branch_misses += other.branch_misses;
+        tlb_misses += other.tlb_misses;
+        return *this;
+    }
+};
+
+// Reads cycles, instructions, cache misses, branch misses and dTLB read
+// misses for the calling thread through perf_event_open.
+//
+// All five events are opened as one group so they are scheduled onto the
+// PMU together and their counts cover exactly the same interval. If the PMU
+// is shared and the group only ran for part of that interval, stop() scales
+// the counts by time enabled / time running, as perf stat does. When the
+// kernel refuses (no PMU, perf_event_paranoid, containers) or the platform
+// isn't Linux, available() is false and stop() returns zeros.
+//
+// Constructing one opens the events, so only do it when counters were asked for.
+class PerfCounters {
+private:
+    static const int EVENT_COUNT = 5;
+    int fds[EVENT_COUNT];
+    bool ok;
+    uint64_t start_enabled = 0;  // Group times at start(); RESET clears counts but not times
+    uint64_t start_running = 0;
+
+#ifdef __linux__
+    static int openEvent(uint32_t type, uint64_t config, int group_fd) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group_fd == -1 ? 1 : 0;  // Only the leader starts disabled
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+#endif
+
+public:
+    PerfCounters() : ok(false) {
+        for (int i = 0; i < EVENT_COUNT; i++) fds[i] = -1;
+#ifdef __linux__
+        const uint32_t types[EVENT_COUNT] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+            PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+        const uint64_t configs[EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+        for (int i = 0; i < EVENT_COUNT; i++) {
+            fds[i] = openEvent(types[i], configs[i], i == 0 ? -1 : fds[0]);
+            if (fds[i] < 0) {
+                closeAll();
+                return;
+            }
+        }
+        ok = true;
+#endif
+    }
+
+    ~PerfCounters() {
+        closeAll();
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        return ok;
+    }
+
+    // Reset and start counting
+    void start() {
+#ifdef __linux__
+        if (!ok) return;
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        uint64_t buffer[3 + EVENT_COUNT];
+        if (readGroup(buffer)) {
+            start_enabled = buffer[1];
+            start_running = buffer[2];
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Stop counting and return the counts since start(), scaled up if the
+    // group was multiplexed off the PMU for part of the time
+    PerfSample stop() {
+        PerfSample sample;
+#ifdef __linux__
+        if (!ok) return sample;
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t buffer[3 + EVENT_COUNT];
+        if (!readGroup(buffer)) return sample;
+        uint64_t enabled = buffer[1] - start_enabled;
+        uint64_t running = buffer[2] - start_running;
+        if (running == 0) return sample;  // Never got onto the PMU
+        double scale = running < enabled ? static_cast<double>(enabled) / running : 1.0;
+        sample.cycles = static_cast<uint64_t>(buffer[3] * scale);
+        sample.instructions = static_cast<uint64_t>(buffer[4] * scale);
+        sample.cache_misses = static_cast<uint64_t>(buffer[5] * scale);
+        sample.branch_misses = static_cast<uint64_t>(buffer[6] * scale);
+        sample.tlb_misses = static_cast<uint64_t>(buffer[7] * scale);
+#endif
+        return sample;
+    }
+
+private:
+#ifdef __linux__
+    // Read the group as { nr, time_enabled, time_running, values[nr] }
+    bool readGroup(uint64_t (&buffer)[3 + EVENT_COUNT]) const {
+        return read(fds[0], buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer));
+    }
+#endif
+
+    void closeAll() {
+#ifdef __linux__
+        for (int i = EVENT_COUNT - 1; i >= 0; i--) {
+            if (fds[i] >= 0) close(fds[i]);
+            fds[i] = -1;
+        }
+#endif
+        ok = false;
+    }
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -1,4 +1,5 @@
 import pandas as pd  # Import Pandas for data manipulation and analysis
+import os  # Import os to check for optional result files
 import matplotlib.pyplot as plt  # Import Matplotlib for plotting
 import seaborn as sns  # Import Seaborn for advanced visualizations
 
@@ -68,3 +69,28 @@ plt.savefig("load_factor_impact.png")
 
 # Display the chart in a window or notebook environment
 plt.show()
+
+# Plot thread scaling if the scalability benchmark has been run
+# The CSV file contains columns: DataStructure, Threads, Operation, OpsPerSec, P50NS, P99NS, Speedup, ...
+if os.path.exists("scalability_results.csv"):
+    scaling = pd.read_csv("scalability_results.csv")
+
+    # Throughput and tail latency side by side, one line per data structure
+    fig, (ax_tput, ax_p99) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.lineplot(data=scaling, x='Threads', y='OpsPerSec', hue='DataStructure', marker='o', ax=ax_tput)
+    sns.lineplot(data=scaling, x='Threads', y='P99NS', hue='DataStructure', marker='o', ax=ax_p99)
+
+    # Thread counts are powers of two, so a log2 x-axis spaces them evenly
+    for ax in (ax_tput, ax_p99):
+        ax.set_xscale('log', base=2)
+        ax.set_xlabel('Threads / Concurrent Clients')
+        ax.grid(True)
+    ax_tput.set_ylabel('Throughput (ops/sec)')
+    ax_tput.set_title('Throughput vs. Thread Count')
+    ax_p99.set_yscale('log')
+    ax_p99.set_ylabel('p99 Latency (ns, log scale)')
+    ax_p99.set_title('Tail Latency vs. Thread Count')
+
+    plt.tight_layout()
+    plt.savefig("scalability.png")
+    plt.show()
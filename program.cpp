@@ -0,0 +1,233 @@
+#include <cstring>
+#include <stdexcept>
+#include "program.hpp"
+
+// Raw FILE/REQUEST encodings.
+//
+// FILE:    [0x04][version][name len: u16][body len: u32][name][body]
+// REQUEST: [0x05][version][name len: u16][name]
+// BATCH:   [0x07][version][file count: u32] then per file
+//          [name len: u16][body len: u32][name][body]
+//
+// All lengths are big-endian. The output is sized once, so encoding a file
+// is a header write plus one memcpy for the name and one for the body.
+// Batches grow by one such record per file.
+
+namespace {
+
+void put_u16(unsigned char* out, size_t value) {
+    out[0] = static_cast<unsigned char>(value >> 8);
+    out[1] = static_cast<unsigned char>(value);
+}
+
+void put_u32(unsigned char* out, size_t value) {
+    out[0] = static_cast<unsigned char>(value >> 24);
+    out[1] = static_cast<unsigned char>(value >> 16);
+    out[2] = static_cast<unsigned char>(value >> 8);
+    out[3] = static_cast<unsigned char>(value);
+}
+
+size_t get_u16(const unsigned char* in) {
+    return (static_cast<size_t>(in[0]) << 8) | in[1];
+}
+
+size_t get_u32(const unsigned char* in) {
+    return (static_cast<size_t>(in[0]) << 24) | (static_cast<size_t>(in[1]) << 16) |
+           (static_cast<size_t>(in[2]) << 8) | in[3];
+}
+
+/**
+ * Checks the type and version bytes of a raw message.
+ *
+ * @throws std::runtime_error if the header is short, of the wrong type,
+ *         or from an unsupported version.
+ */
+void check_raw_header(const std::vector<unsigned char>& data, unsigned char type, size_t header_size) {
+    if (data.size() < header_size || data[0] != type) {
+        throw std::runtime_error("Malformed raw message header");
+    }
+    if (data[1] != RAW_MESSAGE_VERSION) {
+        throw std::runtime_error("Unsupported raw message version");
+    }
+}
+
+}
+
+/**
+ * Serializes a File into the raw FILE encoding.
+ *
+ * @param file The file to serialize.
+ * @return std::vector<unsigned char> The encoded message.
+ * @throws std::length_error if the filename or body is too long for the header.
+ */
+std::vector<unsigned char> serialize_file_raw(const File& file) {
+    std::vector<unsigned char> message;
+    serialize_file_raw(file, message);
+    return message;
+}
+
+/**
+ * Serializes a File into the raw FILE encoding, reusing out's capacity.
+ *
+ * @param file The file to serialize.
+ * @param out Receives the encoded message; previous contents are replaced.
+ * @throws std::length_error if the filename or body is too long for the header.
+ */
+void serialize_file_raw(const File& file, std::vector<unsigned char>& out) {
+    if (file.filename.size() > 0xffff) throw std::length_error("Filename too long");
+    if (file.data.size() > 0xffffffffUL) throw std::length_error("File too large");
+
+    out.resize(RAW_FILE_HEADER_SIZE + file.filename.size() + file.data.size());
+    unsigned char* dst = out.data();
+    dst[0] = FILE_RAW_MESSAGE;
+    dst[1] = RAW_MESSAGE_VERSION;
+    put_u16(dst + 2, file.filename.size());
+    put_u32(dst + 4, file.data.size());
+    dst += RAW_FILE_HEADER_SIZE;
+    std::memcpy(dst, file.filename.data(), file.filename.size());
+    dst += file.filename.size();
+    if (!file.data.empty()) std::memcpy(dst, file.data.data(), file.data.size());
+}
+
+/**
+ * Deserializes a raw FILE message.
+ *
+ * @param data The encoded message.
+ * @return File The decoded file.
+ * @throws std::runtime_error if the message is malformed or truncated.
+ */
+File deserialize_file_raw(const std::vector<unsigned char>& data) {
+    File file;
+    deserialize_file_raw(data, file);
+    return file;
+}
+
+/**
+ * Deserializes a raw FILE message into an existing File, reusing its capacity.
+ *
+ * @param data The encoded message.
+ * @param file Receives the decoded filename and body.
+ * @throws std::runtime_error if the message is malformed or truncated.
+ */
+void deserialize_file_raw(const std::vector<unsigned char>& data, File& file) {
+    check_raw_header(data, FILE_RAW_MESSAGE, RAW_FILE_HEADER_SIZE);
+    size_t name_len = get_u16(data.data() + 2);
+    size_t body_len = get_u32(data.data() + 4);
+    if (data.size() - RAW_FILE_HEADER_SIZE != name_len + body_len) {
+        throw std::runtime_error("Raw FILE message length mismatch");
+    }
+
+    const unsigned char* in = data.data() + RAW_FILE_HEADER_SIZE;
+    file.filename.assign(reinterpret_cast<const char*>(in), name_len);
+    file.data.assign(in + name_len, in + name_len + body_len);
+}
+
+/**
+ * Serializes a Request into the raw REQUEST encoding.
+ *
+ * @param req The request to serialize.
+ * @return std::vector<unsigned char> The encoded message.
+ * @throws std::length_error if the filename is too long for the header.
+ */
+std::vector<unsigned char> serialize_request_raw(const Request& req) {
+    if (req.filename.size() > 0xffff) throw std::length_error("Filename too long");
+
+    std::vector<unsigned char> message(RAW_REQUEST_HEADER_SIZE + req.filename.size());
+    message[0] = REQUEST_RAW_MESSAGE;
+    message[1] = RAW_MESSAGE_VERSION;
+    put_u16(message.data() + 2, req.filename.size());
+    std::memcpy(message.data() + RAW_REQUEST_HEADER_SIZE, req.filename.data(), req.filename.size());
+    return message;
+}
+
+/**
+ * Deserializes a raw REQUEST message.
+ *
+ * @param data The encoded message.
+ * @return Request The decoded request.
+ * @throws std::runtime_error if the message is malformed or truncated.
+ */
+Request deserialize_request_raw(const std::vector<unsigned char>& data) {
+    Request req;
+    deserialize_request_raw(data, req);
+    return req;
+}
+
+/**
+ * Deserializes a raw REQUEST message into an existing Request.
+ *
+ * @param data The encoded message.
+ * @param req Receives the decoded filename.
+ * @throws std::runtime_error if the message is malformed or truncated.
+ */
+void deserialize_request_raw(const std::vector<unsigned char>& data, Request& req) {
+    check_raw_header(data, REQUEST_RAW_MESSAGE, RAW_REQUEST_HEADER_SIZE);
+    size_t name_len = get_u16(data.data() + 2);
+    if (data.size() - RAW_REQUEST_HEADER_SIZE != name_len) {
+        throw std::runtime_error("Raw REQUEST message length mismatch");
+    }
+    req.filename.assign(reinterpret_cast<const char*>(data.data()) + RAW_REQUEST_HEADER_SIZE, name_len);
+}
+
+/**
+ * Appends a file to a BATCH message, writing the header first if batch is empty.
+ *
+ * @param file The file to add.
+ * @param batch The message being built; its file count is updated in place.
+ * @throws std::length_error if the filename or body is too long for the header.
+ */
+void append_batch_file_raw(const File& file, std::vector<unsigned char>& batch) {
+    if (file.filename.size() > 0xffff) throw std::length_error("Filename too long");
+    if (file.data.size() > MAX_FILE_SIZE) throw std::length_error("File too large");
+
+    if (batch.empty()) {
+        batch.resize(RAW_BATCH_HEADER_SIZE);
+        batch[0] = BATCH_MESSAGE;
+        batch[1] = RAW_MESSAGE_VERSION;
+        put_u32(batch.data() + 2, 0);
+    }
+    size_t offset = batch.size();
+    batch.resize(offset + 6 + file.filename.size() + file.data.size());
+    unsigned char* dst = batch.data() + offset;
+    put_u16(dst, file.filename.size());
+    put_u32(dst + 2, file.data.size());
+    dst += 6;
+    std::memcpy(dst, file.filename.data(), file.filename.size());
+    dst += file.filename.size();
+    if (!file.data.empty()) std::memcpy(dst, file.data.data(), file.data.size());
+    put_u32(batch.data() + 2, get_u32(batch.data() + 2) + 1);
+}
+
+/**
+ * Deserializes a BATCH message into files, reusing the File objects already there.
+ *
+ * @param data The encoded message.
+ * @param files Resized to the file count and filled in order.
+ * @throws std::runtime_error if the message is malformed or truncated, or a
+ *         body exceeds MAX_FILE_SIZE; the caller then stores none of the batch.
+ */
+void deserialize_batch_raw(const std::vector<unsigned char>& data, std::vector<File>& files) {
+    check_raw_header(data, BATCH_MESSAGE, RAW_BATCH_HEADER_SIZE);
+    size_t count = get_u32(data.data() + 2);
+    // Every record takes at least 6 bytes, which bounds count before resizing
+    if (count > (data.size() - RAW_BATCH_HEADER_SIZE) / 6) {
+        throw std::runtime_error("BATCH file count exceeds message length");
+    }
+    files.resize(count);
+    size_t pos = RAW_BATCH_HEADER_SIZE;
+    for (File& file : files) {
+        if (data.size() - pos < 6) throw std::runtime_error("Truncated BATCH record");
+        size_t name_len = get_u16(data.data() + pos);
+        size_t body_len = get_u32(data.data() + pos + 2);
+        // Same limit as a single FILE, so every stored file can be requested back;
+        // names are bounded by their u16 length field
+        if (body_len > MAX_FILE_SIZE) throw std::runtime_error("BATCH file exceeds 65535 bytes");
+        pos += 6;
+        if (data.size() - pos < name_len + body_len) throw std::runtime_error("Truncated BATCH record");
+        const unsigned char* in = data.data() + pos;
+        file.filename.assign(reinterpret_cast<const char*>(in), name_len);
+        file.data.assign(in + name_len, in + name_len + body_len);
+        pos += name_len + body_len;
+    }
+    if (pos != data.size()) throw std::runtime_error("BATCH message length mismatch");
+}
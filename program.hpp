@@ -8,6 +8,26 @@
 #define FILE_MESSAGE 0x01
 #define REQUEST_MESSAGE 0x02
 #define STATUS_MESSAGE 0x03
+#define FILE_RAW_MESSAGE 0x04
+#define REQUEST_RAW_MESSAGE 0x05
+// Single-byte request for server metrics; answered with a STATUS whose message is the metrics text
+#define STATS_MESSAGE 0x06
+// Many files in one message; the server keeps the connection open for more
+// messages after a BATCH and answers each with a STATUS
+#define BATCH_MESSAGE 0x07
+
+// Version byte carried by the raw FILE/REQUEST encodings
+#define RAW_MESSAGE_VERSION 0x01
+// Raw FILE header: type, version, u16 filename length, u32 body length
+#define RAW_FILE_HEADER_SIZE 8
+// Raw REQUEST header: type, version, u16 filename length
+#define RAW_REQUEST_HEADER_SIZE 4
+// BATCH header: type, version, u32 file count
+#define RAW_BATCH_HEADER_SIZE 6
+// Largest BATCH the server accepts; other messages stay limited to 70000 bytes
+#define MAX_BATCH_MESSAGE_SIZE (4 * 1024 * 1024)
+// Largest file body the server stores, however it arrives
+#define MAX_FILE_SIZE 65535
 
 // Status codes
 #define STATUS_OK 200
@@ -59,6 +79,25 @@ Request deserialize_request(const std::vector<unsigned char>& data);
 std::vector<unsigned char> serialize_status(const Status& status);
 Status deserialize_status(const std::vector<unsigned char>& data);
 
+// Raw encodings: a fixed big-endian header followed by the filename and body
+// copied as contiguous blobs, instead of one pack109 element per body byte
+std::vector<unsigned char> serialize_file_raw(const File& file);
+File deserialize_file_raw(const std::vector<unsigned char>& data);
+
+std::vector<unsigned char> serialize_request_raw(const Request& req);
+Request deserialize_request_raw(const std::vector<unsigned char>& data);
+
+// Same as above, but write into existing objects so their capacity is reused
+void serialize_file_raw(const File& file, std::vector<unsigned char>& out);
+void deserialize_file_raw(const std::vector<unsigned char>& data, File& file);
+void deserialize_request_raw(const std::vector<unsigned char>& data, Request& req);
+
+// BATCH encoding: a header, then per file the raw FILE fields without the type
+// and version bytes. append_batch_file_raw starts the header on an empty batch.
+void append_batch_file_raw(const File& file, std::vector<unsigned char>& batch);
+// Decodes into files, reusing the capacity of the File objects already there
+void deserialize_batch_raw(const std::vector<unsigned char>& data, std::vector<File>& files);
+
 // Helper function to convert bytes to string
 std::string bytes_to_string(const std::vector<unsigned char>& byte_data);
 
@@ -0,0 +1,379 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "hashset.hpp"
+#include "hashmap.hpp"
+#include "program.hpp"
+#include "histogram.hpp"
+#include "workload.hpp"
+#include "socket_io.hpp"
+
+// Scalability benchmark: runs the same work under 1, 2, 4, ... N threads and
+// reports throughput and latency percentiles per thread count.
+//
+// Container cases use weak scaling (every thread does the same number of
+// operations), so perfect scaling means throughput grows with the thread
+// count. Latencies are recorded per batch of BATCH_OPS operations to keep
+// clock reads out of the measurement. The server case runs closed-loop
+// clients, one connection per REQUEST as the protocol requires.
+
+/// Operations per timed latency sample in the container cases.
+const size_t BATCH_OPS = 64;
+
+/// One row of results.
+struct ScaleResult {
+    std::string structure;
+    int threads;
+    std::string operation;
+    size_t elements;
+    double seconds;
+    uint64_t ops;
+    uint64_t errors;
+    LatencyHistogram latency;
+};
+
+/**
+ * Runs body(thread_index, histogram) on `threads` threads started together,
+ * and returns the wall time from the common start to the last finish.
+ */
+template <typename Body>
+double run_threads(int threads, std::vector<LatencyHistogram>& histograms, Body body) {
+    histograms.assign(threads, LatencyHistogram());
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            ready++;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(t, histograms[t]);
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * Applies ops to a container in batches of BATCH_OPS, recording the mean
+ * nanoseconds per operation of each batch.
+ */
+template <typename Apply>
+void timed_ops(const std::vector<WorkloadOp>& ops, LatencyHistogram& hist, Apply apply) {
+    for (size_t begin = 0; begin < ops.size(); begin += BATCH_OPS) {
+        size_t end = std::min(ops.size(), begin + BATCH_OPS);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = begin; i < end; i++) apply(ops[i]);
+        auto stop = std::chrono::steady_clock::now();
+        hist.record(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / (end - begin));
+    }
+}
+
+/**
+ * HashSet with one private set per thread: no sharing, so this is the
+ * scaling ceiling for the hardware (memory bandwidth, caches, SMT).
+ */
+ScaleResult bench_hashset_private(int threads, const WorkloadConfig& config) {
+    std::vector<Workload> workloads;
+    for (int t = 0; t < threads; t++) {
+        WorkloadConfig per_thread = config;
+        per_thread.seed = config.seed + t;
+        workloads.push_back(generateWorkload(per_thread));
+    }
+
+    // Preloaded up front so the timed region is only the operation stream
+    std::vector<std::unique_ptr<HashSet>> sets;
+    for (int t = 0; t < threads; t++) {
+        sets.emplace_back(new HashSet(std::max<size_t>(1, config.keys / 70)));
+        for (int key : workloads[t].preload) sets[t]->insert(key);
+    }
+
+    std::vector<LatencyHistogram> histograms;
+    double seconds = run_threads(threads, histograms, [&](int t, LatencyHistogram& hist) {
+        HashSet& set = *sets[t];
+        volatile bool sink = false;
+        timed_ops(workloads[t].ops, hist, [&](const WorkloadOp& op) {
+            switch (op.type) {
+                case OpType::Insert: sink = set.insert(op.key); break;
+                case OpType::Lookup: sink = set.contains(op.key); break;
+                case OpType::Remove: sink = set.remove(op.key); break;
+            }
+        });
+        (void)sink;
+    });
+
+    ScaleResult result{"HashSet-private", threads, "Mixed-" + config.distribution, config.keys,
+                       seconds, static_cast<uint64_t>(threads) * config.ops, 0, LatencyHistogram()};
+    for (const LatencyHistogram& h : histograms) result.latency.merge(h);
+    return result;
+}
+
+/**
+ * HashMap shared by all threads behind one mutex, as the server's store
+ * would be if its request loop were multi-threaded. Inserts store a small
+ * File, lookups use find(), removes are treated as lookups (HashMap has no
+ * remove).
+ */
+ScaleResult bench_hashmap_shared(int threads, const WorkloadConfig& config) {
+    std::vector<Workload> workloads;
+    for (int t = 0; t < threads; t++) {
+        WorkloadConfig per_thread = config;
+        per_thread.seed = config.seed + t;
+        workloads.push_back(generateWorkload(per_thread));
+    }
+
+    HashMap map;
+    std::mutex map_mutex;
+    File value("value", std::vector<unsigned char>(64, 'x'));
+    for (int key : workloads[0].preload) map.insert(std::to_string(key), value);
+
+    std::vector<LatencyHistogram> histograms;
+    double seconds = run_threads(threads, histograms, [&](int t, LatencyHistogram& hist) {
+        volatile bool sink = false;
+        std::string key;
+        timed_ops(workloads[t].ops, hist, [&](const WorkloadOp& op) {
+            key = std::to_string(op.key);
+            std::lock_guard<std::mutex> lock(map_mutex);
+            if (op.type == OpType::Insert) sink = map.insert(key, value);
+            else sink = map.find(key) != nullptr;
+        });
+        (void)sink;
+    });
+
+    ScaleResult result{"HashMap-mutex", threads, "Mixed-" + config.distribution, config.keys,
+                       seconds, static_cast<uint64_t>(threads) * config.ops, 0, LatencyHistogram()};
+    for (const LatencyHistogram& h : histograms) result.latency.merge(h);
+    return result;
+}
+
+/**
+ * One REQUEST round trip on a fresh connection.
+ *
+ * @return true if a length-prefixed reply of any type was received.
+ */
+bool request_once(const sockaddr_in& addr, const std::vector<unsigned char>& message,
+                  std::vector<unsigned char>& reply) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    bool ok = connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    uint32_t len = htonl(message.size());
+    ok = ok && send_all(fd, reinterpret_cast<unsigned char*>(&len), sizeof(len));
+    ok = ok && send_all(fd, message.data(), message.size());
+    ok = ok && recv_all(fd, reinterpret_cast<unsigned char*>(&len), sizeof(len));
+    if (ok) {
+        len = ntohl(len);
+        ok = len > 0 && len <= 70000;
+        if (ok) {
+            reply.resize(len);
+            ok = recv_all(fd, reply.data(), len);
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+/**
+ * Whether an encrypted reply is a raw FILE rather than a STATUS such as
+ * "File not found". Only the type byte is decrypted.
+ */
+bool is_file_reply(const std::vector<unsigned char>& reply) {
+    return !reply.empty() && (reply[0] ^ XOR_KEY) == FILE_RAW_MESSAGE;
+}
+
+/**
+ * Requests `filename` once before timing, so a missing file or unreachable
+ * server stops the benchmark instead of timing the error path.
+ *
+ * @return true if the server sent the file back.
+ */
+bool check_file_stored(const sockaddr_in& addr, const std::string& filename) {
+    std::vector<unsigned char> message = serialize_request_raw(Request(filename));
+    xor_crypt(message, XOR_KEY);
+    std::vector<unsigned char> reply;
+    if (!request_once(addr, message, reply)) {
+        std::cerr << "No reply from the server" << std::endl;
+        return false;
+    }
+    if (is_file_reply(reply)) return true;
+    xor_crypt(reply, XOR_KEY);
+    std::string reason = "unexpected reply";
+    if (reply[0] == STATUS_MESSAGE) {
+        try {
+            Status status = deserialize_status(reply);
+            reason = std::to_string(status.code) + " " + status.message;
+        } catch (const std::exception&) {}
+    }
+    std::cerr << "Server did not return " << filename << ": " << reason << std::endl;
+    return false;
+}
+
+/**
+ * File server under `threads` concurrent closed-loop clients, each
+ * requesting `filename` for `duration` seconds.
+ */
+ScaleResult bench_server(int threads, const sockaddr_in& addr, const std::string& filename, double duration) {
+    std::vector<unsigned char> message = serialize_request_raw(Request(filename));
+    xor_crypt(message, XOR_KEY);
+
+    std::vector<uint64_t> ops(threads, 0), errors(threads, 0);
+    std::vector<LatencyHistogram> histograms;
+    double seconds = run_threads(threads, histograms, [&](int t, LatencyHistogram& hist) {
+        std::vector<unsigned char> reply;
+        reply.reserve(70000);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(duration);
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto start = std::chrono::steady_clock::now();
+            // Anything but the file (e.g. a 404 STATUS) is an error, not a fast request
+            bool ok = request_once(addr, message, reply) && is_file_reply(reply);
+            auto stop = std::chrono::steady_clock::now();
+            if (ok) {
+                hist.record(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+                ops[t]++;
+            } else {
+                errors[t]++;
+            }
+        }
+    });
+
+    ScaleResult result{"FileServer", threads, "Request", 1, seconds, 0, 0, LatencyHistogram()};
+    for (int t = 0; t < threads; t++) {
+        result.ops += ops[t];
+        result.errors += errors[t];
+        result.latency.merge(histograms[t]);
+    }
+    return result;
+}
+
+/**
+ * Writes results as CSV. TimeMS is the mean latency per operation in
+ * milliseconds, matching the column plot_charts.py plots.
+ */
+void write_csv(const std::string& path, const std::vector<ScaleResult>& results) {
+    std::ofstream csv(path);
+    if (!csv.is_open()) {
+        std::cerr << "Error opening CSV file: " << path << std::endl;
+        return;
+    }
+    csv << "DataStructure,Threads,Operation,Elements,TimeMS,OpsPerSec,P50NS,P99NS,P999NS,Errors,Speedup\n";
+    for (const ScaleResult& r : results) {
+        double throughput = r.seconds > 0 ? r.ops / r.seconds : 0;
+        // Speedup relative to the single-thread row of the same structure
+        double base = throughput;
+        for (const ScaleResult& b : results) {
+            if (b.structure == r.structure && b.threads == 1 && b.seconds > 0) base = b.ops / b.seconds;
+        }
+        csv << r.structure << "," << r.threads << "," << r.operation << "," << r.elements << ","
+            << r.latency.mean() / 1e6 << "," << throughput << "," << r.latency.percentile(50) << ","
+            << r.latency.percentile(99) << "," << r.latency.percentile(99.9) << "," << r.errors << ","
+            << (base > 0 ? throughput / base : 0) << "\n";
+    }
+    std::cout << "Scalability data written to " << path << std::endl;
+}
+
+/**
+ * Entry point.
+ *
+ * Command line options:
+ *   --max-threads <n>        Largest thread count (default: hardware threads)
+ *   --ops <n>                Operations per thread for container cases
+ *   --keys <n>               Key universe for container cases
+ *   --workload <dist>        Key distribution (see workload.hpp)
+ *   --server <host[:port]>   Also load the file server at this address
+ *   --file <name>            File to request from the server (must exist)
+ *   --duration <seconds>     Time per thread count for the server case
+ *   --output <csv>           Output path (default: scalability_results.csv)
+ */
+int main(int argc, char* argv[]) {
+    int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    WorkloadConfig config;
+    config.ops = 200000;
+    std::string server = "";
+    std::string filename = "";
+    double duration = 2.0;
+    std::string output = "scalability_results.csv";
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--max-threads") max_threads = std::max(1, std::stoi(value));
+            else if (arg == "--ops") config.ops = std::stoul(value);
+            else if (arg == "--keys") config.keys = std::stoul(value);
+            else if (arg == "--workload") config.distribution = value;
+            else if (arg == "--server") server = value;
+            else if (arg == "--file") filename = value;
+            else if (arg == "--duration") duration = std::stod(value);
+            else if (arg == "--output") output = value;
+            else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid arguments: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<int> thread_counts;
+    for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    std::vector<ScaleResult> results;
+    try {
+        for (int threads : thread_counts) {
+            std::cout << "Containers with " << threads << " thread(s)..." << std::endl;
+            results.push_back(bench_hashset_private(threads, config));
+            results.push_back(bench_hashmap_shared(threads, config));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (!server.empty()) {
+        if (filename.empty()) {
+            std::cerr << "--server needs --file naming a file stored on the server" << std::endl;
+            return 1;
+        }
+        auto host_port = parse_hostname(server);
+        sockaddr_in addr;
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(host_port.second);
+        if (inet_pton(AF_INET, host_port.first.c_str(), &addr.sin_addr) <= 0) {
+            if (host_port.first == "localhost") addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            else { std::cerr << "Invalid address: " << host_port.first << std::endl; return 1; }
+        }
+        if (!check_file_stored(addr, filename)) return 1;
+        for (int threads : thread_counts) {
+            std::cout << "File server with " << threads << " client(s)..." << std::endl;
+            results.push_back(bench_server(threads, addr, filename, duration));
+        }
+    }
+
+    for (const ScaleResult& r : results) {
+        std::cout << r.structure << " threads=" << r.threads << " ops/s="
+                  << static_cast<uint64_t>(r.seconds > 0 ? r.ops / r.seconds : 0)
+                  << " p50=" << r.latency.percentile(50) << "ns p99=" << r.latency.percentile(99)
+                  << "ns errors=" << r.errors << std::endl;
+    }
+    write_csv(output, results);
+    return 0;
+}
@@ -8,34 +8,108 @@
 #include <fstream>
 #include <vector>
 #include <csignal>
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <pthread.h>
+#include <semaphore.h>
 #include "pack109.hpp"
 #include "program.hpp"
 #include "hashmap.hpp"
+#include "metrics.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "socket_io.hpp"
+#include "concurrentqueue.h"
+#ifdef HAVE_LIBURING
+#include <fcntl.h>
+#include <memory>
+#include <liburing.h>
+#endif
 
 /// In-memory file storage.
 HashMap file_storage;
+/// Guards file_storage: FILE messages take it exclusively, reads share it.
+std::shared_mutex storage_mutex;
+/// Serializes writes to the persistence file.
+std::mutex persist_mutex;
 /// Path to persistence file, if enabled.
 std::string persistence_file = "";
 /// Server socket file descriptor.
 int server_fd = -1;
-/// Server running flag.
-bool running = true;
+/// Server running flag; cleared by the SIGINT handler.
+volatile sig_atomic_t running = 1;
+/// Path for the Chrome trace dump, if tracing is enabled.
+std::string trace_file = "";
+/// Set by SIGUSR1 to dump the trace after the current connection.
+volatile sig_atomic_t trace_dump_requested = 0;
+/// Request counters and stage latencies, reported by STATS.
+ServerMetrics metrics;
+/// Worker threads serving connections; 0 serves them on the accept thread.
+int worker_count = 0;
+/// Accepted sockets waiting for a worker; -1 tells a worker to exit.
+ConcurrentQueue* connection_queue = nullptr;
+/// Counts the sockets in connection_queue so idle workers can sleep.
+sem_t connection_ready;
+/// Slots in connection_queue; the acceptor waits for a free one when full.
+const int CONNECTION_QUEUE_SIZE = 1024;
+/// Largest accepted message: 65535 bytes of file plus serialization overhead.
+const size_t MAX_MESSAGE_SIZE = 70000;
 
 /**
  * Signal handler for graceful shutdown.
  * 
- * Closes the server socket and sets the running flag to false.
+ * Clears the running flag and closes the server socket, and nothing else:
+ * only async-signal-safe calls belong here, so the main loop logs the
+ * shutdown once accept() returns.
  * @param signal The received signal number.
  */
 void signal_handler(int signal) {
-    std::cout << "\nReceived shutdown signal. Cleaning up..." << std::endl;
-    running = false;
+    running = 0;
     if (server_fd != -1) {
         close(server_fd); // Unblock accept()
         server_fd = -1;
     }
 }
 
+/**
+ * Signal handler for SIGUSR1: requests a trace dump.
+ *
+ * The dump happens in the main loop once the current accept() returns.
+ * @param signal The received signal number.
+ */
+void trace_signal_handler(int signal) {
+    trace_dump_requested = 1;
+}
+
+/**
+ * Encodes the hash map in the persistence file format.
+ *
+ * The format is a uint32 file count, then per file a uint32 name length, the
+ * name, a uint32 data length and the data, all in host byte order.
+ *
+ * @param storage The file storage hash map.
+ * @param out Replaced with the encoded bytes.
+ */
+void encode_storage(const HashMap& storage, std::vector<unsigned char>& out) {
+    std::vector<std::string> keys = storage.keys();
+    out.clear();
+    auto append_u32 = [&out](uint32_t value) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    };
+    append_u32(keys.size());
+    for (const auto& key : keys) {
+        const File* file = storage.find(key);
+        append_u32(file->filename.length());
+        out.insert(out.end(), file->filename.begin(), file->filename.end());
+        append_u32(file->data.size());
+        out.insert(out.end(), file->data.begin(), file->data.end());
+    }
+}
+
 /**
  * Saves the hash map to disk.
  * 
@@ -45,29 +119,36 @@ void signal_handler(int signal) {
  */
 bool save_storage_to_disk(const HashMap& storage, const std::string& filename) {
     if (filename.empty()) return false;
+    TRACE_SPAN("save_storage_to_disk");
     try {
         std::ofstream outfile(filename, std::ios::binary | std::ios::out);
         if (!outfile.is_open()) return false;
-        std::vector<std::string> keys = storage.keys();
-        uint32_t num_files = keys.size();
-        outfile.write(reinterpret_cast<char*>(&num_files), sizeof(num_files));
-        for (const auto& key : keys) {
-            File file = storage.get(key);
-            uint32_t filename_len = file.filename.length();
-            outfile.write(reinterpret_cast<char*>(&filename_len), sizeof(filename_len));
-            outfile.write(file.filename.c_str(), filename_len);
-            uint32_t data_len = file.data.size();
-            outfile.write(reinterpret_cast<char*>(&data_len), sizeof(data_len));
-            outfile.write(reinterpret_cast<const char*>(file.data.data()), data_len);
-        }
+        std::vector<unsigned char> encoded;
+        encode_storage(storage, encoded);
+        outfile.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
         outfile.close();
-        std::cout << "Saved " << num_files << " files to disk: " << filename << std::endl;
+        LOG_DEBUG("Saved %zu files to disk: %s", storage.getSize(), filename.c_str());
         return true;
     } catch (...) {
         return false;
     }
 }
 
+/**
+ * Saves file_storage to the persistence file, if enabled.
+ *
+ * Concurrent callers write the file one at a time; storage stays readable
+ * while it is written.
+ */
+void persist_storage() {
+    if (persistence_file.empty()) return;
+    std::lock_guard<std::mutex> persist_lock(persist_mutex);
+    std::shared_lock<std::shared_mutex> storage_lock(storage_mutex);
+    uint64_t start = metricsNow();
+    save_storage_to_disk(file_storage, persistence_file);
+    metrics.persist_ns.record(metricsNow() - start);
+}
+
 /**
  * Loads the hash map from disk.
  * 
@@ -95,7 +176,7 @@ bool load_storage_from_disk(HashMap& storage, const std::string& filename) {
             storage.insert(filename, file);
         }
         infile.close();
-        std::cout << "Loaded " << num_files << " files from disk: " << filename << std::endl;
+        LOG_INFO("Loaded %u files from disk: %s", num_files, filename.c_str());
         return true;
     } catch (...) {
         return false;
@@ -103,67 +184,756 @@ bool load_storage_from_disk(HashMap& storage, const std::string& filename) {
 }
 
 /**
- * Receives all bytes requested from a socket.
- * 
- * @param sockfd The socket file descriptor.
- * @param data The buffer to fill.
- * @param length The number of bytes to receive.
- * @return true if all bytes are received, false otherwise.
+ * Per-connection scratch state, reused from one connection to the next.
+ *
+ * The buffers are reserved for the largest allowed message up front and the
+ * File/Request objects keep their string and vector capacity between uses,
+ * so small REQUEST/STATUS round trips don't touch the heap.
  */
-bool recv_all(int sockfd, unsigned char* data, size_t length) {
-    size_t total_received = 0;
-    while (total_received < length) {
-        ssize_t received = recv(sockfd, data + total_received, length - total_received, 0);
-        if (received <= 0) return false;
-        total_received += received;
+struct ConnectionContext {
+    std::vector<unsigned char> buffer;
+    std::vector<unsigned char> response;
+    File file;
+    Request request;
+    std::vector<File> batch;
+
+    ConnectionContext() {
+        buffer.reserve(MAX_MESSAGE_SIZE);
+        response.reserve(MAX_MESSAGE_SIZE);
     }
-    return true;
+};
+
+/**
+ * Copies a serialized STATUS message for one of the fixed replies into response.
+ *
+ * The fixed replies are serialized once on first use.
+ *
+ * @param code The status code (STATUS_OK, STATUS_FILE_NOT_FOUND or STATUS_ERROR).
+ * @param response Receives the serialized status.
+ */
+void cached_status(int code, std::vector<unsigned char>& response) {
+    TRACE_SPAN("serialize_status");
+    static const std::vector<unsigned char> file_received = serialize_status(Status(STATUS_OK, "File received successfully"));
+    static const std::vector<unsigned char> not_found = serialize_status(Status(STATUS_FILE_NOT_FOUND, "File not found"));
+    static const std::vector<unsigned char> unknown_type = serialize_status(Status(STATUS_ERROR, "Unknown message type"));
+
+    const std::vector<unsigned char>& cached =
+        code == STATUS_OK ? file_received : code == STATUS_FILE_NOT_FOUND ? not_found : unknown_type;
+    response.assign(cached.begin(), cached.end());
 }
 
 /**
- * Sends all bytes requested over a socket.
- * 
- * @param sockfd The socket file descriptor.
- * @param data The buffer to send.
- * @param length The number of bytes to send.
- * @return true if all bytes are sent, false otherwise.
+ * Serializes a STATUS message into response.
+ *
+ * Copies instead of move-assigning, so response keeps the capacity reserved
+ * for the connection.
+ *
+ * @param status The status to send.
+ * @param response Receives the serialized status.
+ */
+void status_into(const Status& status, std::vector<unsigned char>& response) {
+    TRACE_SPAN("serialize_status");
+    const std::vector<unsigned char> encoded = serialize_status(status);
+    response.assign(encoded.begin(), encoded.end());
+}
+
+/**
+ * Decodes the message in ctx.buffer and writes the reply into ctx.response.
+ *
+ * @param ctx The connection context holding the decrypted message.
  */
-bool send_all(int sockfd, const unsigned char* data, size_t length) {
-    size_t total_sent = 0;
-    while (total_sent < length) {
-        ssize_t sent = send(sockfd, data + total_sent, length - total_sent, 0);
-        if (sent <= 0) return false;
-        total_sent += sent;
+void process_message(ConnectionContext& ctx) {
+    std::vector<unsigned char>& buffer = ctx.buffer;
+    std::vector<unsigned char>& response = ctx.response;
+    try {
+        if (buffer[0] == FILE_MESSAGE || buffer[0] == FILE_RAW_MESSAGE) {
+            metrics.file_requests.fetch_add(1, std::memory_order_relaxed);
+            File& file = ctx.file;
+            uint64_t start = metricsNow();
+            {
+                TRACE_SPAN("deserialize_file");
+                if (buffer[0] == FILE_RAW_MESSAGE) {
+                    deserialize_file_raw(buffer, file);
+                } else {
+                    // Copy the fields so ctx.file keeps its capacity; assigning the File would move over it
+                    const File decoded = deserialize_file(buffer);
+                    file.filename.assign(decoded.filename);
+                    file.data.assign(decoded.data.begin(), decoded.data.end());
+                }
+            }
+            metrics.deserialize_ns.record(metricsNow() - start);
+            LOG_DEBUG("Received file: %s (%zu bytes)", file.filename.c_str(), file.data.size());
+            start = metricsNow();
+            {
+                TRACE_SPAN("HashMap::insert");
+                std::unique_lock<std::shared_mutex> lock(storage_mutex);
+                file_storage.insert(file.filename, file);
+            }
+            metrics.lookup_ns.record(metricsNow() - start);
+            cached_status(STATUS_OK, response);
+        } else if (buffer[0] == REQUEST_MESSAGE || buffer[0] == REQUEST_RAW_MESSAGE) {
+            metrics.get_requests.fetch_add(1, std::memory_order_relaxed);
+            // Raw requests get a raw FILE back; legacy requests keep the pack109 encoding
+            bool raw = buffer[0] == REQUEST_RAW_MESSAGE;
+            Request& request = ctx.request;
+            uint64_t start = metricsNow();
+            {
+                TRACE_SPAN("deserialize_request");
+                if (raw) deserialize_request_raw(buffer, request);
+                else request.filename.assign(deserialize_request(buffer).filename);
+            }
+            metrics.deserialize_ns.record(metricsNow() - start);
+            LOG_DEBUG("File requested: %s", request.filename.c_str());
+            start = metricsNow();
+            // Held until the reply is serialized, since file points into storage
+            std::shared_lock<std::shared_mutex> lock(storage_mutex);
+            const File* file;
+            {
+                TRACE_SPAN("HashMap::find");
+                file = file_storage.find(request.filename);
+            }
+            metrics.lookup_ns.record(metricsNow() - start);
+            if (file != nullptr) {
+                LOG_DEBUG("Sending file: %s (%zu bytes)", file->filename.c_str(), file->data.size());
+                start = metricsNow();
+                {
+                    TRACE_SPAN("serialize_file");
+                    if (raw) {
+                        serialize_file_raw(*file, response);
+                    } else {
+                        const std::vector<unsigned char> encoded = serialize_file(*file);
+                        response.assign(encoded.begin(), encoded.end());
+                    }
+                }
+                metrics.serialize_ns.record(metricsNow() - start);
+            } else {
+                metrics.not_found.fetch_add(1, std::memory_order_relaxed);
+                cached_status(STATUS_FILE_NOT_FOUND, response);
+            }
+        } else if (buffer[0] == BATCH_MESSAGE) {
+            metrics.batch_requests.fetch_add(1, std::memory_order_relaxed);
+            uint64_t start = metricsNow();
+            {
+                // Every record is checked before any is stored, so a bad one rejects the whole batch
+                TRACE_SPAN("deserialize_batch");
+                deserialize_batch_raw(buffer, ctx.batch);
+            }
+            metrics.deserialize_ns.record(metricsNow() - start);
+            start = metricsNow();
+            {
+                // One lock for the whole batch instead of one per file
+                TRACE_SPAN("HashMap::insert");
+                std::unique_lock<std::shared_mutex> lock(storage_mutex);
+                for (const File& file : ctx.batch) file_storage.insert(file.filename, file);
+            }
+            metrics.lookup_ns.record(metricsNow() - start);
+            metrics.batch_files.fetch_add(ctx.batch.size(), std::memory_order_relaxed);
+            LOG_DEBUG("Stored batch of %zu files", ctx.batch.size());
+            status_into(Status(STATUS_OK, "Stored " + std::to_string(ctx.batch.size()) + " files"), response);
+        } else if (buffer[0] == STATS_MESSAGE) {
+            metrics.stats_requests.fetch_add(1, std::memory_order_relaxed);
+            std::shared_lock<std::shared_mutex> lock(storage_mutex);
+            status_into(Status(STATUS_OK, metrics.render(file_storage.getSize(), file_storage.getCapacity())), response);
+        } else {
+            metrics.unknown_requests.fetch_add(1, std::memory_order_relaxed);
+            cached_status(STATUS_ERROR, response);
+        }
+    } catch (const std::exception& e) {
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        status_into(Status(STATUS_ERROR, e.what()), response);
+    }
+}
+
+/**
+ * Decrypts the message received into ctx.buffer, processes it and leaves the
+ * encrypted reply in ctx.response.
+ *
+ * @param ctx The connection context holding the received message.
+ * @param batch Set to whether the message was a BATCH.
+ * @return false if the message is too large for its type and the connection
+ *         should be dropped without a reply.
+ */
+bool prepare_reply(ConnectionContext& ctx, bool& batch) {
+    metrics.bytes_in.fetch_add(ctx.buffer.size(), std::memory_order_relaxed);
+    {
+        TRACE_SPAN("xor_crypt");
+        xor_crypt(ctx.buffer, XOR_KEY);
+    }
+    batch = ctx.buffer[0] == BATCH_MESSAGE;
+    if (!batch && ctx.buffer.size() > MAX_MESSAGE_SIZE) {
+        LOG_WARN("Invalid message size: %zu bytes", ctx.buffer.size());
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    process_message(ctx);
+    {
+        TRACE_SPAN("xor_crypt");
+        xor_crypt(ctx.response, XOR_KEY);
     }
     return true;
 }
 
 /**
- * Parses a hostname string with optional port (format: host:port).
- * 
- * @param hostname The hostname string to parse.
- * @return std::pair<std::string, int> The host and port as a pair.
+ * Receives one length-prefixed message, processes it and sends the reply.
+ *
+ * @param client_socket The accepted client socket.
+ * @param ctx Reusable buffers for this connection.
+ * @param first Whether this is the connection's first message; a clean close
+ *              before a later message is the client finishing, not an error.
+ * @return true if the message was a BATCH that was answered, so the client
+ *         may send another on the same connection.
  */
-std::pair<std::string, int> parse_hostname(const std::string& hostname) {
-    size_t colon_pos = hostname.find(':');
-    if (colon_pos == std::string::npos) return std::make_pair(hostname, 8081);
-    std::string host = hostname.substr(0, colon_pos);
-    int port = std::stoi(hostname.substr(colon_pos + 1));
-    return std::make_pair(host, port);
+bool handle_message(int client_socket, ConnectionContext& ctx, bool first) {
+    // Receive length prefix
+    uint32_t msg_len = 0;
+    ssize_t peeked = 1;
+    if (!first) {
+        do {
+            peeked = recv(client_socket, &msg_len, 1, MSG_PEEK);
+        } while (peeked < 0 && errno == EINTR);
+    }
+    if (peeked == 0) return false;
+    if (peeked < 0 || !recv_all(client_socket, reinterpret_cast<unsigned char*>(&msg_len), sizeof(msg_len))) {
+        LOG_WARN("Error reading message length");
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    msg_len = ntohl(msg_len);
+
+    // 65535 bytes for the file + max 1024 bytes overhead for serialization,
+    // or up to MAX_BATCH_MESSAGE_SIZE for a BATCH (checked once decrypted)
+    if (msg_len == 0 || msg_len > MAX_BATCH_MESSAGE_SIZE) {
+        LOG_WARN("Invalid message size: %u bytes", msg_len);
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // resize() within the reserved capacity doesn't allocate; a BATCH grows it once
+    ctx.buffer.resize(msg_len);
+    if (!recv_all(client_socket, ctx.buffer.data(), msg_len)) {
+        LOG_WARN("Error reading message");
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    bool batch;
+    if (!prepare_reply(ctx, batch)) return false;
+
+    // Send length prefix
+    uint64_t send_start = metricsNow();
+    uint32_t resp_len = htonl(ctx.response.size());
+    if (!send_all(client_socket, reinterpret_cast<unsigned char*>(&resp_len), sizeof(resp_len))) {
+        LOG_WARN("Error sending response length");
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!send_all(client_socket, ctx.response.data(), ctx.response.size())) {
+        LOG_WARN("Error sending response");
+        metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    metrics.send_ns.record(metricsNow() - send_start);
+    metrics.bytes_out.fetch_add(ctx.response.size(), std::memory_order_relaxed);
+    return batch;
+}
+
+/**
+ * Serves a connection and closes it.
+ *
+ * Most clients send one message per connection. After a BATCH the server
+ * keeps reading, so a bulk ingest streams all its batches over one connection
+ * and the caller persists storage once at the end.
+ *
+ * @param client_socket The accepted client socket.
+ * @param ctx Reusable buffers for this connection.
+ */
+void handle_connection(int client_socket, ConnectionContext& ctx) {
+    TRACE_SPAN("handle_connection");
+    bool first = true;
+    while (handle_message(client_socket, ctx, first)) first = false;
+    close(client_socket);
 }
 
+/**
+ * Worker thread body: serves sockets from connection_queue until it dequeues -1.
+ *
+ * Each worker owns its ConnectionContext, so buffers are never shared.
+ */
+void worker_loop() {
+    ConnectionContext ctx;
+    for (;;) {
+        while (sem_wait(&connection_ready) != 0 && errno == EINTR) {}
+        void* item;
+        // Every post follows an insert, so the queue can't be empty here
+        if (concurrentRemoveHead(connection_queue, &item) != 0) continue;
+        int client_socket = static_cast<int>(reinterpret_cast<intptr_t>(item));
+        if (client_socket < 0) break;
+        handle_connection(client_socket, ctx);
+        persist_storage();
+    }
+}
+
+/**
+ * Hands a socket (or the -1 exit marker) to the workers.
+ *
+ * @param client_socket The accepted socket, or -1 to stop one worker.
+ */
+void enqueue_connection(int client_socket) {
+    // A full queue means every worker is busy; wait for one to take a socket
+    while (concurrentInsertAtTail(connection_queue, reinterpret_cast<void*>(static_cast<intptr_t>(client_socket))) != 0) {
+        std::this_thread::yield();
+    }
+    sem_post(&connection_ready);
+}
+
+#ifdef HAVE_LIBURING
+/// Submission queue size of the io_uring backend's ring.
+const unsigned URING_ENTRIES = 256;
+/// Connections that receive into a registered buffer; any more use a heap buffer.
+const int URING_REGISTERED_BUFFERS = 64;
+/// Receive buffer size: a length prefix plus the largest non-BATCH message.
+const size_t URING_BUFFER_SIZE = sizeof(uint32_t) + MAX_MESSAGE_SIZE;
+/// user_data of the operations that don't belong to a connection. Connection
+/// operations carry the connection's address, whose low 3 bits hold the kind.
+const uint64_t URING_ACCEPT = 1;
+const uint64_t URING_PERSIST = 2;
+const uint64_t URING_RECV = 0, URING_SEND_LENGTH = 1, URING_SEND_BODY = 2;
+
+/**
+ * A connection served by the io_uring backend.
+ *
+ * Bytes arrive in in[0, received), which is the connection's registered buffer
+ * or its inbox when all registered buffers are taken. A message too large for
+ * that (a BATCH) is received straight into ctx.buffer instead.
+ */
+struct alignas(8) UringConnection {
+    int fd = -1;
+    int buffer_index = -1;       // registered buffer, or -1 when receiving into inbox
+    unsigned char* in = nullptr;
+    size_t received = 0;
+    std::vector<unsigned char> inbox;
+    bool large = false;          // receiving a large message into ctx.buffer
+    size_t large_received = 0;
+    bool first = true;           // no message read yet
+    bool keep_open = false;      // the reply being sent answers a BATCH
+    bool failed = false;         // part of the reply could not be sent
+    int pending = 0;             // submitted operations not yet completed
+    uint32_t reply_length = 0;   // length prefix of the reply, network order
+    size_t reply_sent = 0;       // reply body bytes sent
+    uint64_t send_start = 0;
+    ConnectionContext ctx;
+};
+
+/**
+ * Single-threaded io_uring event loop, used instead of the blocking accept
+ * loop with --io-uring.
+ *
+ * One multishot accept stays armed on the listening socket. Connections
+ * receive into buffers registered with the ring, each reply goes out as a
+ * linked pair of sends (length prefix, then body), and the persistence file
+ * is written with async writes, at most one save at a time. All submissions
+ * and completions of an iteration share one io_uring_enter() call, where the
+ * blocking path makes a recv() or send() call per chunk.
+ */
+class UringServer {
+public:
+    ~UringServer() {
+        if (initialized) io_uring_queue_exit(&ring);
+    }
+
+    /**
+     * Sets up the ring and registers the receive buffers.
+     *
+     * @param listen_fd The listening socket.
+     * @return false if io_uring is unavailable, in which case the caller
+     *         serves connections with blocking I/O.
+     */
+    bool init(int listen_fd) {
+        this->listen_fd = listen_fd;
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+        int ret = io_uring_queue_init_params(URING_ENTRIES, &ring, &params);
+        if (ret == -EINVAL) {
+            // Kernels before 6.0 don't know these flags
+            memset(&params, 0, sizeof(params));
+            ret = io_uring_queue_init_params(URING_ENTRIES, &ring, &params);
+        }
+        if (ret < 0) {
+            LOG_WARN("io_uring setup failed: %s", strerror(-ret));
+            return false;
+        }
+        initialized = true;
+
+        buffers.resize(URING_REGISTERED_BUFFERS * URING_BUFFER_SIZE);
+        std::vector<iovec> iovecs(URING_REGISTERED_BUFFERS);
+        for (int i = 0; i < URING_REGISTERED_BUFFERS; i++) {
+            iovecs[i].iov_base = buffers.data() + i * URING_BUFFER_SIZE;
+            iovecs[i].iov_len = URING_BUFFER_SIZE;
+        }
+        ret = io_uring_register_buffers(&ring, iovecs.data(), iovecs.size());
+        if (ret < 0) {
+            // Usually RLIMIT_MEMLOCK; every connection then gets a heap buffer
+            LOG_WARN("Could not register io_uring buffers: %s", strerror(-ret));
+            buffers.clear();
+        } else {
+            for (int i = URING_REGISTERED_BUFFERS - 1; i >= 0; i--) free_buffers.push_back(i);
+        }
+        arm_accept();
+        return true;
+    }
+
+    /**
+     * Serves connections until shutdown, then finishes the open connections
+     * and any save in progress.
+     */
+    void run() {
+        while (running || open_connections > 0 || persist_fd >= 0) {
+            int ret = io_uring_submit_and_wait(&ring, 1);
+            if (ret < 0 && ret != -EINTR) {
+                LOG_ERROR("io_uring_submit_and_wait failed: %s", strerror(-ret));
+                break;
+            }
+            io_uring_cqe* cqe;
+            unsigned head;
+            unsigned seen = 0;
+            io_uring_for_each_cqe(&ring, head, cqe) {
+                complete(cqe->user_data, cqe->res, cqe->flags);
+                seen++;
+            }
+            io_uring_cq_advance(&ring, seen);
+
+            if (trace_dump_requested) {
+                trace_dump_requested = 0;
+                if (trace::dump(trace_file)) LOG_INFO("Trace written to %s", trace_file.c_str());
+                else LOG_WARN("Failed to write trace to %s", trace_file.c_str());
+            }
+        }
+        for (auto& conn : connections) {
+            if (conn->fd >= 0) close(conn->fd);
+        }
+    }
+
+private:
+    io_uring ring;
+    bool initialized = false;
+    int listen_fd = -1;
+    bool multishot_accept = true;
+    std::vector<unsigned char> buffers;          // the registered receive buffers, back to back
+    std::vector<int> free_buffers;
+    std::vector<std::unique_ptr<UringConnection>> connections;
+    std::vector<UringConnection*> idle;          // closed connections kept for reuse
+    int open_connections = 0;
+    bool storage_dirty = false;                  // files stored since the last save began
+    int persist_fd = -1;                         // persistence file while a save is in flight
+    std::vector<unsigned char> persist_data;
+    size_t persist_written = 0;
+    uint64_t persist_start = 0;
+
+    /**
+     * Returns a free submission queue entry, submitting queued ones if the queue is full.
+     */
+    io_uring_sqe* get_sqe() {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+        while (sqe == nullptr) {
+            io_uring_submit(&ring);
+            sqe = io_uring_get_sqe(&ring);
+        }
+        return sqe;
+    }
+
+    static uint64_t tag(UringConnection* conn, uint64_t kind) {
+        return reinterpret_cast<uintptr_t>(conn) | kind;
+    }
+
+    void arm_accept() {
+        io_uring_sqe* sqe = get_sqe();
+        if (multishot_accept) io_uring_prep_multishot_accept(sqe, listen_fd, nullptr, nullptr, 0);
+        else io_uring_prep_accept(sqe, listen_fd, nullptr, nullptr, 0);
+        io_uring_sqe_set_data64(sqe, URING_ACCEPT);
+    }
+
+    /**
+     * Dispatches one completion.
+     */
+    void complete(uint64_t user_data, int res, unsigned flags) {
+        if (user_data == URING_ACCEPT) {
+            on_accept(res, flags);
+        } else if (user_data == URING_PERSIST) {
+            on_persist_write(res);
+        } else {
+            UringConnection* conn = reinterpret_cast<UringConnection*>(user_data & ~uint64_t(7));
+            conn->pending--;
+            if ((user_data & 7) == URING_RECV) on_receive(conn, res);
+            else on_send(conn, (user_data & 7) == URING_SEND_LENGTH, res);
+        }
+    }
+
+    void on_accept(int res, unsigned flags) {
+        bool armed = (flags & IORING_CQE_F_MORE) != 0;
+        if (res == -EINVAL && multishot_accept) {
+            // Multishot accept needs Linux 5.19; accept one connection per submission instead
+            LOG_INFO("Multishot accept unsupported; using single accepts");
+            multishot_accept = false;
+        } else if (res < 0) {
+            if (running) LOG_WARN("Error accepting connection");
+        } else if (!running) {
+            close(res);
+        } else {
+            open_connection(res);
+        }
+        if (!armed && running) arm_accept();
+    }
+
+    void open_connection(int fd) {
+        UringConnection* conn;
+        if (!idle.empty()) {
+            conn = idle.back();
+            idle.pop_back();
+        } else {
+            connections.emplace_back(new UringConnection());
+            conn = connections.back().get();
+        }
+        conn->fd = fd;
+        conn->received = 0;
+        conn->large = false;
+        conn->first = true;
+        if (!free_buffers.empty()) {
+            conn->buffer_index = free_buffers.back();
+            free_buffers.pop_back();
+            conn->in = buffers.data() + conn->buffer_index * URING_BUFFER_SIZE;
+        } else {
+            conn->buffer_index = -1;
+            conn->inbox.resize(URING_BUFFER_SIZE);
+            conn->in = conn->inbox.data();
+        }
+        open_connections++;
+        receive(conn);
+    }
+
+    void close_connection(UringConnection* conn) {
+        close(conn->fd);
+        conn->fd = -1;
+        if (conn->buffer_index >= 0) free_buffers.push_back(conn->buffer_index);
+        conn->buffer_index = -1;
+        idle.push_back(conn);
+        open_connections--;
+        // Like the blocking path, save once the connection is done
+        if (storage_dirty) persist();
+    }
+
+    void receive(UringConnection* conn) {
+        io_uring_sqe* sqe = get_sqe();
+        if (conn->large) {
+            io_uring_prep_recv(sqe, conn->fd, conn->ctx.buffer.data() + conn->large_received,
+                               conn->ctx.buffer.size() - conn->large_received, MSG_WAITALL);
+        } else if (conn->buffer_index >= 0) {
+            io_uring_prep_read_fixed(sqe, conn->fd, conn->in + conn->received,
+                                     URING_BUFFER_SIZE - conn->received, 0, conn->buffer_index);
+        } else {
+            io_uring_prep_recv(sqe, conn->fd, conn->in + conn->received, URING_BUFFER_SIZE - conn->received, 0);
+        }
+        io_uring_sqe_set_data64(sqe, tag(conn, URING_RECV));
+        conn->pending++;
+    }
+
+    void on_receive(UringConnection* conn, int res) {
+        if (res <= 0) {
+            // A close between messages is the client finishing, as in handle_message
+            if (res < 0 || conn->first || conn->received > 0 || conn->large) {
+                LOG_WARN("Error reading message");
+                metrics.errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            close_connection(conn);
+            return;
+        }
+        if (conn->large) {
+            conn->large_received += res;
+            if (conn->large_received < conn->ctx.buffer.size()) {
+                receive(conn);
+            } else {
+                conn->large = false;
+                reply(conn);
+            }
+            return;
+        }
+        conn->received += res;
+        dispatch(conn);
+    }
+
+    /**
+     * Replies to the message at the start of conn->in once it is complete,
+     * otherwise receives more of it.
+     */
+    void dispatch(UringConnection* conn) {
+        uint32_t msg_len;
+        if (conn->received < sizeof(msg_len)) {
+            receive(conn);
+            return;
+        }
+        memcpy(&msg_len, conn->in, sizeof(msg_len));
+        msg_len = ntohl(msg_len);
+        if (msg_len == 0 || msg_len > MAX_BATCH_MESSAGE_SIZE) {
+            LOG_WARN("Invalid message size: %u bytes", msg_len);
+            metrics.errors.fetch_add(1, std::memory_order_relaxed);
+            close_connection(conn);
+            return;
+        }
+        size_t total = sizeof(msg_len) + msg_len;
+        if (total > URING_BUFFER_SIZE) {
+            // Bigger than the receive buffer, which therefore holds nothing past it
+            size_t have = conn->received - sizeof(msg_len);
+            conn->ctx.buffer.resize(msg_len);
+            memcpy(conn->ctx.buffer.data(), conn->in + sizeof(msg_len), have);
+            conn->large_received = have;
+            conn->received = 0;
+            conn->large = true;
+            receive(conn);
+            return;
+        }
+        if (conn->received < total) {
+            receive(conn);
+            return;
+        }
+        conn->ctx.buffer.assign(conn->in + sizeof(msg_len), conn->in + total);
+        // Keep anything the client already sent of its next message
+        memmove(conn->in, conn->in + total, conn->received - total);
+        conn->received -= total;
+        reply(conn);
+    }
+
+    /**
+     * Processes the message in conn->ctx.buffer and sends the reply.
+     */
+    void reply(UringConnection* conn) {
+        conn->first = false;
+        bool batch;
+        if (!prepare_reply(conn->ctx, batch)) {
+            close_connection(conn);
+            return;
+        }
+        unsigned char type = conn->ctx.buffer[0];
+        if (batch || type == FILE_MESSAGE || type == FILE_RAW_MESSAGE) storage_dirty = true;
+        conn->keep_open = batch;
+        conn->failed = false;
+        conn->reply_sent = 0;
+        conn->reply_length = htonl(conn->ctx.response.size());
+        conn->send_start = metricsNow();
+
+        // Both halves of the link must go in the same submission
+        if (io_uring_sq_space_left(&ring) < 2) io_uring_submit(&ring);
+        io_uring_sqe* sqe = get_sqe();
+        io_uring_prep_send(sqe, conn->fd, &conn->reply_length, sizeof(conn->reply_length), MSG_WAITALL | MSG_NOSIGNAL);
+        io_uring_sqe_set_data64(sqe, tag(conn, URING_SEND_LENGTH));
+        sqe->flags |= IOSQE_IO_LINK;
+        conn->pending++;
+        send_body(conn);
+    }
+
+    void send_body(UringConnection* conn) {
+        io_uring_sqe* sqe = get_sqe();
+        io_uring_prep_send(sqe, conn->fd, conn->ctx.response.data() + conn->reply_sent,
+                           conn->ctx.response.size() - conn->reply_sent, MSG_WAITALL | MSG_NOSIGNAL);
+        io_uring_sqe_set_data64(sqe, tag(conn, URING_SEND_BODY));
+        conn->pending++;
+    }
+
+    void on_send(UringConnection* conn, bool length_prefix, int res) {
+        if (length_prefix) {
+            if (res != sizeof(conn->reply_length)) conn->failed = true;
+        } else if (res <= 0) {
+            conn->failed = true; // -ECANCELED if the length prefix failed
+        } else {
+            conn->reply_sent += res;
+            if (!conn->failed && conn->reply_sent < conn->ctx.response.size()) send_body(conn);
+        }
+        if (conn->pending > 0) return;
+        if (conn->failed) {
+            LOG_WARN("Error sending response");
+            metrics.errors.fetch_add(1, std::memory_order_relaxed);
+            close_connection(conn);
+            return;
+        }
+        metrics.send_ns.record(metricsNow() - conn->send_start);
+        metrics.bytes_out.fetch_add(conn->ctx.response.size(), std::memory_order_relaxed);
+        // After a BATCH the client may send more, and part of it may be here already
+        if (conn->keep_open) dispatch(conn);
+        else close_connection(conn);
+    }
+
+    /**
+     * Starts saving file_storage with async writes, unless a save is in
+     * flight; that save starts another when it finishes if storage changed.
+     */
+    void persist() {
+        if (persistence_file.empty()) {
+            storage_dirty = false;
+            return;
+        }
+        if (persist_fd >= 0) return;
+        storage_dirty = false;
+        persist_start = metricsNow();
+        {
+            TRACE_SPAN("encode_storage");
+            std::shared_lock<std::shared_mutex> storage_lock(storage_mutex);
+            encode_storage(file_storage, persist_data);
+        }
+        persist_fd = open(persistence_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (persist_fd < 0) {
+            LOG_WARN("Failed to open %s", persistence_file.c_str());
+            return;
+        }
+        persist_written = 0;
+        write_persist_data();
+    }
+
+    void write_persist_data() {
+        io_uring_sqe* sqe = get_sqe();
+        io_uring_prep_write(sqe, persist_fd, persist_data.data() + persist_written,
+                            persist_data.size() - persist_written, persist_written);
+        io_uring_sqe_set_data64(sqe, URING_PERSIST);
+    }
+
+    void on_persist_write(int res) {
+        if (res > 0) {
+            persist_written += res;
+            if (persist_written < persist_data.size()) {
+                write_persist_data();
+                return;
+            }
+        } else {
+            LOG_WARN("Error writing %s: %s", persistence_file.c_str(), strerror(res < 0 ? -res : EIO));
+        }
+        close(persist_fd);
+        persist_fd = -1;
+        metrics.persist_ns.record(metricsNow() - persist_start);
+        if (storage_dirty) persist();
+    }
+};
+#endif
+
 /**
  * Main server entry point.
  * 
  * Parses command-line arguments, sets up persistence, handles signals,
  * and runs the main server loop to accept and process client connections.
  * 
+ * Command line options:
+ *   --hostname, -h <host[:port]>  Address to report and port to listen on (default: localhost:8082)
+ *   --persist, -p <file>          Load storage from and save it to this file
+ *   --trace, -t <file>            Write a Chrome trace of request spans here at shutdown and on
+ *                                 SIGUSR1 (after the next connection); needs -DENABLE_TRACING
+ *   --workers, -w <n>             Serve connections on n worker threads fed by the accept
+ *                                 thread through a lock-free queue (default: 0, serve inline)
+ *   --io-uring, -u                Serve connections from one io_uring event loop; needs
+ *                                 -DHAVE_LIBURING and -luring, else blocking I/O is used
+ * 
  * @return int Exit status code.
  */
 int main(int argc, char *argv[]) {
     // Defaults
     std::string hostname = "localhost";
     int port = 8082;
+    bool use_io_uring = false;
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -184,23 +954,52 @@ int main(int argc, char *argv[]) {
                 std::cerr << "Missing value for --persist" << std::endl;
                 return 1;
             }
+        } else if (arg == "--trace" || arg == "-t") {
+            if (i + 1 < argc) {
+                trace_file = argv[++i];
+            } else {
+                std::cerr << "Missing value for --trace" << std::endl;
+                return 1;
+            }
+            if (!trace::enabled()) {
+                std::cerr << "Tracing is not compiled in; rebuild with -DENABLE_TRACING" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--workers" || arg == "-w") {
+            if (i + 1 < argc) {
+                worker_count = std::stoi(argv[++i]);
+            } else {
+                std::cerr << "Missing value for --workers" << std::endl;
+                return 1;
+            }
+            if (worker_count < 0) {
+                std::cerr << "--workers must be 0 or more" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--io-uring" || arg == "-u") {
+            use_io_uring = true;
         }
     }
 
     // Load storage if needed
     if (!persistence_file.empty()) {
         if (!load_storage_from_disk(file_storage, persistence_file)) {
-            std::cerr << "Failed to load storage from disk" << std::endl;
+            LOG_ERROR("Failed to load storage from disk");
             return 1;
         }
     }
 
-    // Register signal handler
-    std::signal(SIGINT, signal_handler);
+    // Register signal handlers. SIGINT goes in without SA_RESTART so it
+    // interrupts a blocked accept(); closing the socket alone doesn't wake it.
+    struct sigaction shutdown_action = {};
+    shutdown_action.sa_handler = signal_handler;
+    sigemptyset(&shutdown_action.sa_mask);
+    sigaction(SIGINT, &shutdown_action, nullptr);
+    if (!trace_file.empty()) std::signal(SIGUSR1, trace_signal_handler);
 
     // Create socket
     server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd < 0) { std::cerr << "Error creating socket" << std::endl; return 1; }
+    if (server_fd < 0) { LOG_ERROR("Error creating socket"); return 1; }
 
     int opt = 1;
     setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt));
@@ -211,17 +1010,52 @@ int main(int argc, char *argv[]) {
     address.sin_addr.s_addr = INADDR_ANY;
 
     if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
-        std::cerr << "Error binding socket to port " << port << std::endl;
+        LOG_ERROR("Error binding socket to port %d", port);
         close(server_fd); return 1;
     }
 
-    if (listen(server_fd, 3) < 0) {
-        std::cerr << "Error listening for connections" << std::endl;
+    if (listen(server_fd, SOMAXCONN) < 0) {
+        LOG_ERROR("Error listening for connections");
         close(server_fd); return 1;
     }
 
-    std::cout << "Server started on " << hostname << ":" << port << std::endl;
-    if (!persistence_file.empty()) std::cout << "Using persistence file: " << persistence_file << std::endl;
+    LOG_INFO("Server started on %s:%d", hostname.c_str(), port);
+    if (!persistence_file.empty()) LOG_INFO("Using persistence file: %s", persistence_file.c_str());
+
+    // Buffers are reused across connections so steady-state requests don't allocate
+    ConnectionContext connection;
+
+    if (use_io_uring) {
+#ifdef HAVE_LIBURING
+        UringServer uring;
+        if (uring.init(server_fd)) {
+            if (worker_count > 0) LOG_WARN("Ignoring --workers: io_uring serves connections on one thread");
+            LOG_INFO("Serving connections with io_uring");
+            uring.run();
+            running = 0; // Skip the blocking loop below
+        } else {
+            LOG_WARN("Falling back to blocking I/O");
+        }
+#else
+        LOG_WARN("io_uring support is not compiled in (rebuild with -DHAVE_LIBURING -luring); using blocking I/O");
+#endif
+    }
+
+    std::vector<std::thread> workers;
+    if (worker_count > 0 && running) {
+        connection_queue = createConcurrentQueue(CONNECTION_QUEUE_SIZE);
+        if (connection_queue == nullptr || sem_init(&connection_ready, 0, 0) != 0) {
+            LOG_ERROR("Error creating the connection queue");
+            close(server_fd); return 1;
+        }
+        // Workers inherit a blocked mask, so SIGINT always interrupts accept() here
+        sigset_t all_signals, previous;
+        sigfillset(&all_signals);
+        pthread_sigmask(SIG_BLOCK, &all_signals, &previous);
+        for (int i = 0; i < worker_count; i++) workers.emplace_back(worker_loop);
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        LOG_INFO("Serving connections on %d worker threads", worker_count);
+    }
 
     while (running) {
         struct sockaddr_in client_address;
@@ -229,90 +1063,44 @@ int main(int argc, char *argv[]) {
         int client_socket = accept(server_fd, (struct sockaddr *)&client_address, &client_addrlen);
         if (client_socket < 0) {
             if (!running) break;
-            std::cerr << "Error accepting connection" << std::endl;
+            if (errno != EINTR) LOG_WARN("Error accepting connection");
             continue;
         }
 
-        // === CHANGE: Increased message size limit to 70000 bytes ===
-        // Receive length prefix
-        uint32_t msg_len = 0;
-        if (!recv_all(client_socket, reinterpret_cast<unsigned char*>(&msg_len), sizeof(msg_len))) {
-            std::cerr << "Error reading message length" << std::endl;
-            close(client_socket); continue;
-        }
-        msg_len = ntohl(msg_len);
-
-        // Updated size limit to accommodate serialization overhead
-        // 65535 bytes for the file + max 1024 bytes overhead for serialization
-        if (msg_len > 70000) {
-            std::cerr << "Message too large: " << msg_len << " bytes" << std::endl;
-            close(client_socket); continue;
-        }
-
-        std::vector<unsigned char> buffer(msg_len);
-        if (!recv_all(client_socket, buffer.data(), msg_len)) {
-            std::cerr << "Error reading message" << std::endl;
-            close(client_socket); continue;
+        if (worker_count > 0) {
+            enqueue_connection(client_socket);
+        } else {
+            handle_connection(client_socket, connection);
+            // Save to disk if persistence enabled
+            persist_storage();
         }
 
-        xor_crypt(buffer, XOR_KEY);
-
-        std::vector<unsigned char> response;
-        try {
-            if (buffer[0] == FILE_MESSAGE) {
-                File file = deserialize_file(buffer);
-                // === CHANGE: Added debug output for file reception ===
-                std::cout << "Received file: " << file.filename << " (" << file.data.size() << " bytes)" << std::endl;
-                // === END CHANGE ===
-                file_storage.insert(file.filename, file);
-                Status status(STATUS_OK, "File received successfully");
-                response = serialize_status(status);
-            } else if (buffer[0] == REQUEST_MESSAGE) {
-                Request request = deserialize_request(buffer);
-                // === CHANGE: Added debug output for file request ===
-                std::cout << "File requested: " << request.filename << std::endl;
-                // === END CHANGE ===
-                if (file_storage.contains(request.filename)) {
-                    File file = file_storage.get(request.filename);
-                    // === CHANGE: Added debug output for file sending ===
-                    std::cout << "Sending file: " << file.filename << " (" << file.data.size() << " bytes)" << std::endl;
-                    // === END CHANGE ===
-                    response = serialize_file(file);
-                } else {
-                    Status status(STATUS_FILE_NOT_FOUND, "File not found");
-                    response = serialize_status(status);
-                }
-            } else {
-                Status status(STATUS_ERROR, "Unknown message type");
-                response = serialize_status(status);
-            }
-        } catch (const std::exception& e) {
-            Status status(STATUS_ERROR, e.what());
-            response = serialize_status(status);
+        if (trace_dump_requested) {
+            trace_dump_requested = 0;
+            if (trace::dump(trace_file)) LOG_INFO("Trace written to %s", trace_file.c_str());
+            else LOG_WARN("Failed to write trace to %s", trace_file.c_str());
         }
+    }
 
-        xor_crypt(response, XOR_KEY);
-
-        // Send length prefix
-        uint32_t resp_len = htonl(response.size());
-        if (!send_all(client_socket, reinterpret_cast<unsigned char*>(&resp_len), sizeof(resp_len))) {
-            std::cerr << "Error sending response length" << std::endl;
-            close(client_socket); continue;
-        }
-        if (!send_all(client_socket, response.data(), response.size())) {
-            std::cerr << "Error sending response" << std::endl;
-            close(client_socket); continue;
-        }
-        close(client_socket);
+    LOG_INFO("Shutting down. Cleaning up...");
 
-        // Save to disk if persistence enabled
-        if (!persistence_file.empty()) save_storage_to_disk(file_storage, persistence_file);
+    // Let workers finish the sockets already queued, then stop them
+    for (size_t i = 0; i < workers.size(); i++) enqueue_connection(-1);
+    for (std::thread& worker : workers) worker.join();
+    if (connection_queue != nullptr) {
+        freeConcurrentQueue(connection_queue);
+        sem_destroy(&connection_ready);
     }
 
     // Save storage to disk before shutting down
     if (!persistence_file.empty()) save_storage_to_disk(file_storage, persistence_file);
 
-    std::cout << "Server shut down" << std::endl;
+    if (!trace_file.empty()) {
+        if (trace::dump(trace_file)) LOG_INFO("Trace written to %s", trace_file.c_str());
+        else LOG_WARN("Failed to write trace to %s", trace_file.c_str());
+    }
+
+    LOG_INFO("Server shut down");
     close(server_fd);
     return 0;
 }
@@ -0,0 +1,70 @@
+#ifndef SOCKET_IO_HPP
+#define SOCKET_IO_HPP
+
+#include <cerrno>
+#include <string>
+#include <utility>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include "trace.hpp"
+
+// Socket helpers shared by the server, the client and the scalability
+// benchmark: whole-buffer send/recv over blocking sockets and host:port
+// parsing. Calls interrupted by a signal are retried. The send and recv spans
+// only record in -DENABLE_TRACING builds.
+
+/**
+ * Receives all bytes requested from a socket.
+ *
+ * @param sockfd The socket file descriptor.
+ * @param data The buffer to fill.
+ * @param length The number of bytes to receive.
+ * @return true if all bytes are received, false otherwise.
+ */
+inline bool recv_all(int sockfd, unsigned char* data, size_t length) {
+    TRACE_SPAN("recv");
+    size_t total_received = 0;
+    while (total_received < length) {
+        ssize_t received = recv(sockfd, data + total_received, length - total_received, 0);
+        if (received < 0 && errno == EINTR) continue;  // A signal without SA_RESTART, e.g. the server's SIGINT
+        if (received <= 0) return false;
+        total_received += received;
+    }
+    return true;
+}
+
+/**
+ * Sends all bytes requested over a socket.
+ *
+ * @param sockfd The socket file descriptor.
+ * @param data The buffer to send.
+ * @param length The number of bytes to send.
+ * @return true if all bytes are sent, false otherwise.
+ */
+inline bool send_all(int sockfd, const unsigned char* data, size_t length) {
+    TRACE_SPAN("send");
+    size_t total_sent = 0;
+    while (total_sent < length) {
+        ssize_t sent = send(sockfd, data + total_sent, length - total_sent, 0);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        total_sent += sent;
+    }
+    return true;
+}
+
+/**
+ * Parses a hostname string with optional port (format: host:port).
+ *
+ * @param hostname The hostname string to parse.
+ * @return std::pair<std::string, int> The host and port (8081 if none is given).
+ */
+inline std::pair<std::string, int> parse_hostname(const std::string& hostname) {
+    size_t colon_pos = hostname.find(':');
+    if (colon_pos == std::string::npos) return std::make_pair(hostname, 8081);
+    std::string host = hostname.substr(0, colon_pos);
+    int port = std::stoi(hostname.substr(colon_pos + 1));
+    return std::make_pair(host, port);
+}
+
+#endif // SOCKET_IO_HPP
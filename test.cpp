@@ -276,5 +276,47 @@ int main() {
   std::map<string, u8> deserialized_map = pack109::deserialize_map_u8(bytes21);
   test("Test 32 - map de", deserialized_map["k"] == 0x42 ? 1 : 0, 1);
 
+  // Test bulk numeric arrays (must match the per-element encoding above)
+  testvec("Test 33 - u64 array bulk ser", pack109::serialize_bulk(u64_array), v18);
+  testvec<u64>("Test 34 - u64 array bulk de", pack109::deserialize_vec_u64_bulk(v18), u64_array);
+  testvec("Test 35 - f64 array bulk ser", pack109::serialize_bulk(f64_array), v19);
+  testvec<f64>("Test 36 - f64 array bulk de", pack109::deserialize_vec_f64_bulk(v19), f64_array);
+
+  std::vector<f64> f64_large;
+  for (int i = 0; i < 1000; i++) {
+    f64_large.push_back(i * 0.5);
+  }
+  vec bytes37 = pack109::serialize_bulk(f64_large);
+  test("Test 37 - f64 large array header", bytes37[0], (u8)PACK109_A16);
+  testvec<f64>("Test 38 - f64 large array bulk de", pack109::deserialize_vec_f64_bulk(bytes37), f64_large);
+
+  // Test 32-bit length headers
+  vec header39;
+  pack109::append_array_header(header39, 70000);
+  vec v39{0xb1, 0x00, 0x01, 0x11, 0x70};
+  testvec("Test 39 - A32 header ser", header39, v39);
+
+  size_t header_len40 = 0;
+  test("Test 40 - A32 header de", pack109::read_array_header(v39.data(), v39.size(), header_len40), (size_t)70000);
+
+  vec header41;
+  pack109::append_string_header(header41, 100000);
+  vec v41{0xb0, 0x00, 0x01, 0x86, 0xa0};
+  testvec("Test 41 - S32 header ser", header41, v41);
+
+  // Test streaming iteration
+  pack109::ArrayReader reader42(v18);
+  pack109::Slice element42;
+  std::vector<u64> streamed42;
+  while (reader42.next(element42)) {
+    streamed42.push_back(pack109::deserialize_u64(element42.to_vec()));
+  }
+  testvec<u64>("Test 42 - array reader", streamed42, u64_array);
+
+  pack109::MapReader reader43(v21);
+  pack109::Slice value43;
+  test("Test 43 - map reader find", reader43.find("k", value43), true);
+  test("Test 44 - map reader value", pack109::deserialize_u8(value43.to_vec()), (u8)0x42);
+
   return 0;
 }
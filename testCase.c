@@ -101,6 +101,7 @@ X: End of test*/
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h> //realloc for the compiled suite
 
  int test(List* list, char* testC) {
     int index = 0;
@@ -263,3 +264,184 @@ X: End of test*/
     return 0;//test passed
 }
 
+
+//Grow the op array or the test table; doubling keeps appends O(1) on average
+static int reserveOps(TestSuite* suite, size_t* capacity) {
+    if (suite->opCount < *capacity) {
+        return 0;
+    }
+    size_t newCapacity = *capacity ? *capacity * 2 : 1024;
+    TestOp* ops = (TestOp*)realloc(suite->ops, newCapacity * sizeof(TestOp));
+    if (!ops) {
+        return 1;
+    }
+    suite->ops = ops;
+    *capacity = newCapacity;
+    return 0;
+}
+
+static int addTestStart(TestSuite* suite, size_t* capacity, size_t start) {
+    if (suite->testCount + 1 >= *capacity) {
+        size_t newCapacity = *capacity ? *capacity * 2 : 256;
+        size_t* starts = (size_t*)realloc(suite->starts, newCapacity * sizeof(size_t));
+        if (!starts) {
+            return 1;
+        }
+        suite->starts = starts;
+        *capacity = newCapacity;
+    }
+    suite->starts[++suite->testCount] = start;
+    return 0;
+}
+
+//Read an optionally negative integer at text[*pos]; no digits reads as 0 like a failed sscanf would skip
+static int readNumber(const char* text, size_t length, size_t* pos) {
+    size_t i = *pos;
+    int negative = i < length && text[i] == '-';
+    if (negative) {
+        i++;
+    }
+    int value = 0;
+    while (i < length && text[i] >= '0' && text[i] <= '9') {
+        value = value * 10 + (text[i] - '0');
+        i++;
+    }
+    *pos = i;
+    return negative ? -value : value;
+}
+
+int compileTests(const char* text, size_t length, TestSuite* suite) {
+    size_t opCapacity = 0, startCapacity = 0;
+    suite->ops = NULL;
+    suite->opCount = 0;
+    suite->starts = NULL;
+    suite->testCount = 0;
+    startCapacity = 256;
+    suite->starts = (size_t*)malloc(startCapacity * sizeof(size_t));
+    if (!suite->starts) {
+        return 1;
+    }
+    suite->starts[0] = 0; //test 0 starts at the first op
+
+    size_t i = 0;
+    while (i < length) {
+        char c = text[i];
+        if (c == '-' && i + 1 < length && text[i + 1] == '-') {
+            while (i < length && text[i] != '\n') { //comment line
+                i++;
+            }
+            continue;
+        }
+        i++;
+        if (!strchr("HTNDCEAQZSWX", c) || c == '\0') {
+            continue; //separators and anything else test() would skip
+        }
+        if (reserveOps(suite, &opCapacity) != 0) {
+            return 1;
+        }
+        TestOp* op = &suite->ops[suite->opCount++];
+        op->command = c;
+        op->index = 0;
+        op->value = 0;
+        switch (c) {
+            case 'H': case 'T': case 'A': case 'Z': case 'S': case 'W':
+                op->value = readNumber(text, length, &i);
+                break;
+            case 'N': case 'Q':
+                op->index = readNumber(text, length, &i);
+                if (i < length && text[i] == ',') {
+                    i++;
+                }
+                op->value = readNumber(text, length, &i);
+                break;
+            case 'E':
+                op->index = readNumber(text, length, &i);
+                break;
+            case 'X':
+                if (addTestStart(suite, &startCapacity, suite->opCount) != 0) {
+                    return 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    //ops after the last X form a final test, as test() would run them too
+    if (suite->opCount > suite->starts[suite->testCount]) {
+        if (addTestStart(suite, &startCapacity, suite->opCount) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int runCompiledTest(List* list, const TestOp* ops, size_t count, size_t* failedOp) {
+    for (size_t i = 0; i < count; i++) {
+        const TestOp* op = &ops[i];
+        int ok = 1;
+        switch (op->command) {
+            case 'H'://insert at head
+                ok = insertAtHead(list, (void*)(intptr_t)op->value) == 0;
+                break;
+            case 'T'://insert at tail
+                ok = insertAtTail(list, (void*)(intptr_t)op->value) == 0;
+                break;
+            case 'N'://insert at specific index
+                ok = insertAtIndex(list, op->index, (void*)(intptr_t)op->value) == 0;
+                break;
+            case 'D'://remove head; checked for emptiness first, so removing a 0 item isn't taken as failure
+                ok = list->head != NULL;
+                if (ok) {
+                    removeHead(list);
+                }
+                break;
+            case 'C'://remove tail
+                ok = list->tail != NULL;
+                if (ok) {
+                    removeTail(list);
+                }
+                break;
+            case 'E'://remove at specific index
+                ok = op->index >= 0 && op->index < size(list);
+                if (ok) {
+                    removeAtIndex(list, op->index);
+                }
+                break;
+            case 'A'://assert head value
+                ok = list->head != NULL && (intptr_t)(list->head->item) == op->value;
+                break;
+            case 'Z'://assert tail value
+                ok = list->tail != NULL && (intptr_t)(list->tail->item) == op->value;
+                break;
+            case 'Q'://assert value at specific index
+                ok = op->index >= 0 && op->index < size(list) && (intptr_t)itemAtIndex(list, op->index) == op->value;
+                break;
+            case 'S'://size
+                ok = size(list) == op->value;
+                break;
+            case 'W'://assert list contains value
+                ok = contains(list, (void*)(intptr_t)op->value);
+                break;
+            case 'X':
+                return 0;
+            default:
+                ok = 0;
+        }
+        if (!ok) {
+            if (failedOp) {
+                *failedOp = i;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void freeTestSuite(TestSuite* suite) {
+    free(suite->ops);
+    free(suite->starts);
+    suite->ops = NULL;
+    suite->starts = NULL;
+    suite->opCount = 0;
+    suite->testCount = 0;
+}
@@ -6,4 +6,30 @@
 
 int test(List* list, char* testC); // Function prototype for test
 
+#include <stddef.h> // size_t for the compiled form below
+
+//Compiled form of the same bytecode, for running large suites without parsing or printing per step
+typedef struct {
+    char command;   //one of HTNDCEAQZSWX
+    int index;      //N, Q and E
+    int value;      //H, T, A, Z, S, W, N and Q
+} TestOp;
+
+typedef struct {
+    TestOp* ops;     //every test's ops back to back
+    size_t opCount;
+    size_t* starts;  //test i is ops[starts[i]] up to ops[starts[i + 1]]; starts has testCount + 1 entries
+    size_t testCount;
+} TestSuite;
+
+//Tokenize text in one pass (it needn't be NUL-terminated, so an mmap'd file works).
+//Each test ends at X; "--" starts a comment to the end of the line. Returns 0, or 1 if out of memory.
+int compileTests(const char* text, size_t length, TestSuite* suite);
+
+//Run one compiled test on an empty list without printing. Returns 0 if it passed, or 1 and
+//sets *failedOp (if not NULL) to the offset of the failing op within the test
+int runCompiledTest(List* list, const TestOp* ops, size_t count, size_t* failedOp);
+
+void freeTestSuite(TestSuite* suite);
+
 #endif
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>       //clock_gettime for per-test timing
+#include <fcntl.h>      //open
+#include <unistd.h>     //close, sysconf
+#include <sys/mman.h>   //mmap the suite instead of reading it line by line
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "testCase.h"
+
+//Runs large suites of the linked-list test bytecode that test() in testCase.c
+//interprets. The file is memory-mapped and compiled in one pass by compileTests(),
+//then independent tests are spread over threads, each with its own List and
+//node pool. Every test is timed on its own.
+//
+//Build: gcc -std=gnu11 -O2 -pthread testrunner.c testCase.c lib.c -o testrunner
+//Usage: testrunner [--threads N] [--times FILE] FILE
+//         run every test in FILE; --times writes Test,NS,Result for each test as CSV
+//       testrunner --generate TESTS OPS [--seed S]
+//         print TESTS random tests of about OPS ops whose assertions hold for a correct list
+
+#define CLAIM_TESTS 1024   //tests a thread claims at a time
+#define SHOW_FAILURES 20
+#define SHOW_SLOWEST 5
+
+typedef struct {
+    const TestSuite* suite;
+    atomic_size_t next;     //next unclaimed test
+    uint64_t* ns;           //per-test time
+    unsigned char* failed;
+    size_t* failedOp;
+} RunState;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void* runWorker(void* arg) {
+    RunState* state = (RunState*)arg;
+    const TestSuite* suite = state->suite;
+    NodePool pool; //nodes are recycled from one test to the next instead of going back to malloc
+    initNodePool(&pool);
+    List list;
+    initList(&list);
+    useNodePool(&list, &pool);
+    for (;;) {
+        size_t begin = atomic_fetch_add(&state->next, CLAIM_TESTS);
+        if (begin >= suite->testCount) {
+            break;
+        }
+        size_t end = begin + CLAIM_TESTS < suite->testCount ? begin + CLAIM_TESTS : suite->testCount;
+        for (size_t t = begin; t < end; t++) {
+            const TestOp* ops = suite->ops + suite->starts[t];
+            size_t count = suite->starts[t + 1] - suite->starts[t];
+            uint64_t start = nowNs();
+            state->failed[t] = (unsigned char)runCompiledTest(&list, ops, count, &state->failedOp[t]);
+            state->ns[t] = nowNs() - start;
+            freeList(&list); //O(1) with the pool; the list stays attached to it
+        }
+    }
+    destroyNodePool(&pool);
+    return NULL;
+}
+
+static int compareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+//Print tests random tests; a plain int array is the reference list
+static void generateTests(size_t tests, size_t ops, unsigned int seed) {
+    srand(seed);
+    int* model = (int*)malloc((ops + 1) * sizeof(int));
+    if (!model) {
+        return;
+    }
+    printf("-- Generated: %zu tests x %zu ops, seed %u\n", tests, ops, seed);
+    for (size_t t = 0; t < tests; t++) {
+        int length = 0;
+        for (size_t i = 0; i < ops; i++) {
+            int roll = rand() % 100;
+            int value = rand() % 2001 - 1000;
+            if (roll < 45 || length == 0) { //insert: head, tail or index
+                int kind = rand() % 3;
+                int index = kind == 0 ? 0 : kind == 1 ? length : rand() % (length + 1);
+                memmove(model + index + 1, model + index, (length - index) * sizeof(int));
+                model[index] = value;
+                length++;
+                if (kind == 0) printf("H%d", value);
+                else if (kind == 1) printf("T%d", value);
+                else printf("N%d,%d", index, value);
+            } else if (roll < 70) { //remove: head, tail or index
+                int kind = rand() % 3;
+                int index = kind == 0 ? 0 : kind == 1 ? length - 1 : rand() % length;
+                memmove(model + index, model + index + 1, (length - index - 1) * sizeof(int));
+                length--;
+                if (kind == 0) printf("D");
+                else if (kind == 1) printf("C");
+                else printf("E%d", index);
+            } else { //assert
+                int kind = rand() % 5;
+                int index = rand() % length;
+                if (kind == 0) printf("A%d", model[0]);
+                else if (kind == 1) printf("Z%d", model[length - 1]);
+                else if (kind == 2) printf("Q%d,%d", index, model[index]);
+                else if (kind == 3) printf("W%d", model[index]);
+                else printf("S%d", length);
+            }
+        }
+        printf("S%dX\n", length);
+    }
+    free(model);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "--generate") == 0) {
+        unsigned int seed = 42;
+        if (argc >= 6 && strcmp(argv[4], "--seed") == 0) {
+            seed = (unsigned int)strtoul(argv[5], NULL, 10);
+        }
+        generateTests(strtoull(argv[2], NULL, 10), strtoull(argv[3], NULL, 10), seed);
+        return 0;
+    }
+
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* timesPath = NULL;
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--times") == 0 && i + 1 < argc) {
+            timesPath = argv[++i];
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == NULL) {
+        fprintf(stderr, "Usage: %s [--threads N] [--times FILE] FILE | --generate TESTS OPS [--seed S]\n", argv[0]);
+        return 2;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    //map the whole suite; the tokenizer reads it once front to back
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror("error");
+        return 2;
+    }
+    TestSuite suite;
+    int compiled;
+    if (st.st_size == 0) {
+        compiled = compileTests("", 0, &suite);
+    } else {
+        const char* text = (const char*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (text == MAP_FAILED) {
+            perror("error");
+            close(fd);
+            return 2;
+        }
+        madvise((void*)text, st.st_size, MADV_SEQUENTIAL);
+        compiled = compileTests(text, st.st_size, &suite);
+        munmap((void*)text, st.st_size);
+    }
+    close(fd);
+    if (compiled != 0) {
+        fprintf(stderr, "Out of memory compiling %s\n", path);
+        return 2;
+    }
+
+    size_t n = suite.testCount;
+    RunState state;
+    state.suite = &suite;
+    atomic_init(&state.next, 0);
+    state.ns = (uint64_t*)calloc(n ? n : 1, sizeof(uint64_t));
+    state.failed = (unsigned char*)calloc(n ? n : 1, 1);
+    state.failedOp = (size_t*)calloc(n ? n : 1, sizeof(size_t));
+    pthread_t* workers = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    if (!state.ns || !state.failed || !state.failedOp || !workers) {
+        fprintf(stderr, "Out of memory\n");
+        return 2;
+    }
+
+    uint64_t wallStart = nowNs();
+    long started = 1; //this thread is one of the workers
+    while (started < threads && pthread_create(&workers[started], NULL, runWorker, &state) == 0) {
+        started++;
+    }
+    runWorker(&state);
+    for (long i = 1; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    double wall = (nowNs() - wallStart) / 1e9;
+
+    size_t failures = 0;
+    for (size_t t = 0; t < n; t++) {
+        failures += state.failed[t];
+    }
+    printf("Tests: %zu, ops: %zu, threads: %ld\n", n, suite.opCount, started);
+    printf("Passed: %zu, failed: %zu\n", n - failures, failures);
+    printf("Wall time: %.3f s (%.0f tests/s, %.0f ops/s)\n", wall,
+           wall > 0 ? n / wall : 0.0, wall > 0 ? suite.opCount / wall : 0.0);
+
+    if (n > 0) {
+        uint64_t* sorted = (uint64_t*)malloc(n * sizeof(uint64_t));
+        if (sorted) {
+            memcpy(sorted, state.ns, n * sizeof(uint64_t));
+            qsort(sorted, n, sizeof(uint64_t), compareU64);
+            printf("Per-test ns: min %llu, median %llu, p99 %llu, max %llu\n",
+                   (unsigned long long)sorted[0], (unsigned long long)sorted[n / 2],
+                   (unsigned long long)sorted[(size_t)(n * 0.99)], (unsigned long long)sorted[n - 1]);
+            //slowest tests: anything at or above the SHOW_SLOWEST-th largest time
+            uint64_t cutoff = sorted[n > SHOW_SLOWEST ? n - SHOW_SLOWEST : 0];
+            int shown = 0;
+            printf("Slowest:");
+            for (size_t t = 0; t < n && shown < SHOW_SLOWEST; t++) {
+                if (state.ns[t] >= cutoff) {
+                    printf(" test %zu (%llu ns)", t + 1, (unsigned long long)state.ns[t]);
+                    shown++;
+                }
+            }
+            printf("\n");
+            free(sorted);
+        }
+    }
+
+    size_t shownFailures = 0;
+    for (size_t t = 0; t < n && shownFailures < SHOW_FAILURES; t++) {
+        if (state.failed[t]) {
+            const TestOp* op = &suite.ops[suite.starts[t] + state.failedOp[t]];
+            printf("Test %zu failed at op %zu (%c)\n", t + 1, state.failedOp[t] + 1, op->command);
+            shownFailures++;
+        }
+    }
+    if (failures > shownFailures) {
+        printf("... and %zu more failures\n", failures - shownFailures);
+    }
+
+    if (timesPath) {
+        FILE* times = fopen(timesPath, "w");
+        if (times) {
+            fprintf(times, "Test,NS,Result\n");
+            for (size_t t = 0; t < n; t++) {
+                fprintf(times, "%zu,%llu,%s\n", t + 1, (unsigned long long)state.ns[t], state.failed[t] ? "fail" : "pass");
+            }
+            fclose(times);
+        } else {
+            perror("error");
+        }
+    }
+
+    free(state.ns);
+    free(state.failed);
+    free(state.failedOp);
+    free(workers);
+    freeTestSuite(&suite);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <string>
+
+// Scoped trace spans exported in Chrome trace-event format.
+//
+// TRACE_SPAN("name") records the time from that line to the end of the
+// enclosing scope. Each thread appends to its own fixed-size ring with no
+// locking; once full it overwrites its oldest spans, so a dump always holds
+// each thread's most recent TRACE_BUFFER_EVENTS spans. trace::dump() writes
+// them as JSON that chrome://tracing or Perfetto can open.
+//
+// Spans only exist when built with -DENABLE_TRACING. Otherwise TRACE_SPAN
+// expands to nothing and dump() does nothing, so instrumented code costs
+// nothing in normal builds.
+
+#ifdef ENABLE_TRACING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS 65536  // Spans kept per thread
+#endif
+
+namespace trace {
+
+    struct Event {
+        const char* name;  // Must outlive the dump; string literals in practice
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    };
+
+    // One thread's spans, as a ring: span number n lives in events[n % TRACE_BUFFER_EVENTS].
+    // Only the owning thread writes; count (spans ever recorded) is published
+    // with release so a concurrent dump reads only completed events.
+    struct ThreadBuffer {
+        Event events[TRACE_BUFFER_EVENTS];
+        std::atomic<size_t> count;
+        uint32_t tid;
+
+        explicit ThreadBuffer(uint32_t id) : count(0), tid(id) {}
+    };
+
+    // All buffers ever created; they live until exit so a dump can still
+    // read the spans of threads that have finished
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    inline Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    inline uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - registry().epoch).count();
+    }
+
+    inline ThreadBuffer& localBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (buffer == nullptr) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.buffers.emplace_back(new ThreadBuffer(static_cast<uint32_t>(r.buffers.size() + 1)));
+            buffer = r.buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    // Record a finished span on the calling thread, overwriting its oldest if the ring is full
+    inline void record(const char* name, uint64_t start_ns, uint64_t duration_ns) {
+        ThreadBuffer& buffer = localBuffer();
+        size_t written = buffer.count.load(std::memory_order_relaxed);
+        buffer.events[written % TRACE_BUFFER_EVENTS] = Event{name, start_ns, duration_ns};
+        buffer.count.store(written + 1, std::memory_order_release);
+    }
+
+    class Span {
+    private:
+        const char* name;
+        uint64_t start;
+
+    public:
+        explicit Span(const char* span_name) : name(span_name), start(now()) {}
+
+        ~Span() { record(name, start, now() - start); }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+    };
+
+    // Write nanoseconds as microseconds with exactly three decimals. A double at
+    // the stream's default precision drops to 100 us steps after 10 s of uptime.
+    inline void writeMicros(std::ostream& out, uint64_t ns) {
+        char fraction[4] = {char('0' + ns % 1000 / 100), char('0' + ns % 100 / 10), char('0' + ns % 10), '\0'};
+        out << ns / 1000 << '.' << fraction;
+    }
+
+    // Write each thread's most recent spans; safe while other threads keep tracing
+    inline bool dump(const std::string& path) {
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        int pid = static_cast<int>(getpid());
+        std::vector<Event> copy;
+        for (const std::unique_ptr<ThreadBuffer>& buffer : r.buffers) {
+            // Copy the ring, then drop any slot the owner may have overwritten while we copied
+            size_t end = buffer->count.load(std::memory_order_acquire);
+            size_t begin = end > TRACE_BUFFER_EVENTS ? end - TRACE_BUFFER_EVENTS : 0;
+            copy.clear();
+            for (size_t n = begin; n < end; n++) copy.push_back(buffer->events[n % TRACE_BUFFER_EVENTS]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            size_t now_written = buffer->count.load(std::memory_order_relaxed);
+            size_t skip = now_written - begin > TRACE_BUFFER_EVENTS ? now_written - begin - TRACE_BUFFER_EVENTS : 0;
+            for (size_t i = std::min(skip, copy.size()); i < copy.size(); i++) {
+                const Event& e = copy[i];
+                // Chrome expects microseconds; names are identifiers, so no escaping
+                out << (first ? "" : ",") << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":";
+                writeMicros(out, e.start_ns);
+                out << ",\"dur\":";
+                writeMicros(out, e.duration_ns);
+                out << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid << "}";
+                first = false;
+            }
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        return out.good();
+    }
+
+    inline bool enabled() { return true; }
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name) trace::Span TRACE_CONCAT(trace_span_, __LINE__)(name)
+
+#else
+
+namespace trace {
+
+    inline bool dump(const std::string&) { return false; }
+
+    inline bool enabled() { return false; }
+
+}
+
+#define TRACE_SPAN(name) do { } while (0)
+
+#endif // ENABLE_TRACING
+
+#endif // TRACE_HPP
@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>   // reading the dump back
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Tests for trace.hpp, built with tracing on and a small ring so wrapping is cheap to reach.
+// Usage: trace_test   (writes and removes trace_test.json in the working directory)
+#define ENABLE_TRACING
+#define TRACE_BUFFER_EVENTS 8
+#include "trace.hpp"
+
+using std::string;
+
+void test(const char *label, bool passed, const string &detail) {
+  printf("%s: ", label);
+  if (passed) {
+    printf("Passed\n");
+  } else {
+    printf("Failed\n");
+    printf("  %s\n", detail.c_str());
+    exit(1);
+  }
+}
+
+// Dump the trace and return the text of every "ts" value, in file order
+std::vector<string> dumpTimestamps() {
+  const char *path = "trace_test.json";
+  if (!trace::dump(path)) {
+    printf("Could not write %s\n", path);
+    exit(1);
+  }
+  std::ifstream in(path);
+  string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  remove(path);
+  std::vector<string> ts;
+  for (size_t pos = json.find("\"ts\":"); pos != string::npos; pos = json.find("\"ts\":", pos)) {
+    pos += 5;
+    ts.push_back(json.substr(pos, json.find(',', pos) - pos));
+  }
+  return ts;
+}
+
+int main() {
+  // A full ring keeps the newest spans: 20 recorded, spans 12..19 dumped oldest first
+  for (uint64_t i = 0; i < 20; i++) trace::record("span", i * 1000, 1);
+  std::vector<string> ts = dumpTimestamps();
+  string got;
+  for (const string &t : ts) got += t + " ";
+  test("Test 1 - ring keeps the newest spans",
+       ts.size() == 8 && ts.front() == "12.000" && ts.back() == "19.000", got);
+
+  // Spans recorded after a dump still show up in the next one
+  trace::record("later", 50000, 1);
+  ts = dumpTimestamps();
+  test("Test 2 - later spans reach the next dump", ts.size() == 8 && ts.back() == "50.000", ts.back());
+
+  // Three hours in, ts still carries nanosecond digits rather than 1.08e+10
+  trace::record("uptime", 10800000000123ull, 4567);
+  ts = dumpTimestamps();
+  test("Test 3 - exact ts after 3 h of uptime", ts.back() == "10800000000.123", ts.back());
+
+  // A real scoped span lands in the same ring
+  { TRACE_SPAN("scoped"); }
+  ts = dumpTimestamps();
+  test("Test 4 - TRACE_SPAN records", ts.size() == 8 && ts.back() != "10800000000.123", ts.back());
+  return 0;
+}
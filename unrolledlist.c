@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>  //memmove/memcpy for shifting items inside a block
+#include <stdbool.h>
+#include "unrolledlist.h"
+
+_Static_assert(sizeof(Block) == UNROLLED_BLOCK_BYTES, "Block must fill its cache lines exactly");
+
+// Initialize an empty list
+void initUnrolledList(UnrolledList* list_pointer) {
+    list_pointer->head = NULL;
+    list_pointer->tail = NULL;
+    list_pointer->length = 0;
+}
+
+// Allocate an empty cache-line-aligned block
+static Block* createBlock(void) {
+    //sizeof(Block) is a multiple of the alignment, as aligned_alloc requires
+    Block* block = (Block*)aligned_alloc(UNROLLED_CACHE_LINE, sizeof(Block));
+    if (!block) {
+        return NULL;
+    }
+    block->next = NULL;
+    block->prev = NULL;
+    block->count = 0;
+    block->unused = 0;
+    return block;
+}
+
+// Link newBlock into the list right after block (or at the head if block is NULL)
+static void linkAfter(UnrolledList* list_pointer, Block* block, Block* newBlock) {
+    newBlock->prev = block;
+    newBlock->next = block ? block->next : list_pointer->head;
+    if (newBlock->next) {
+        newBlock->next->prev = newBlock;
+    } else {
+        list_pointer->tail = newBlock;
+    }
+    if (block) {
+        block->next = newBlock;
+    } else {
+        list_pointer->head = newBlock;
+    }
+}
+
+// Unlink block from the list and free it
+static void unlinkBlock(UnrolledList* list_pointer, Block* block) {
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        list_pointer->head = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    } else {
+        list_pointer->tail = block->prev;
+    }
+    free(block);
+}
+
+// Find the block holding item index (0 <= index < length) and its offset there.
+// Walks from whichever end is closer, one block per UNROLLED_BLOCK_ITEMS items.
+static Block* findBlock(UnrolledList* list_pointer, int index, int* offset) {
+    Block* block;
+    if (index < list_pointer->length / 2) {
+        block = list_pointer->head;
+        while (index >= block->count) {
+            index -= block->count;
+            block = block->next;
+        }
+    } else {
+        int fromEnd = list_pointer->length - 1 - index; //items after index
+        block = list_pointer->tail;
+        while (fromEnd >= block->count) {
+            fromEnd -= block->count;
+            block = block->prev;
+        }
+        index = block->count - 1 - fromEnd;
+    }
+    *offset = index;
+    return block;
+}
+
+// Insert new item at the end of list.
+int unrolledInsertAtTail(UnrolledList* list_pointer, void* item) {
+    Block* tail = list_pointer->tail;
+    //appends fill blocks completely, so a list built from the tail is fully packed
+    if (!tail || tail->count == (int)UNROLLED_BLOCK_ITEMS) {
+        Block* newBlock = createBlock();
+        if (!newBlock) {
+            return 1;
+        }
+        linkAfter(list_pointer, tail, newBlock);
+        tail = newBlock;
+    }
+    tail->items[tail->count++] = item;
+    list_pointer->length++;
+    return 0;
+}
+
+// Insert item at start of the list.
+int unrolledInsertAtHead(UnrolledList* list_pointer, void* item) {
+    return unrolledInsertAtIndex(list_pointer, 0, item);
+}
+
+// Insert item at a specified index.
+int unrolledInsertAtIndex(UnrolledList* list_pointer, int index, void* item) {
+    if (list_pointer == NULL || index < 0 || index > list_pointer->length) {
+        return 1;
+    }
+    if (index == list_pointer->length) {
+        return unrolledInsertAtTail(list_pointer, item);
+    }
+
+    int offset;
+    Block* block = findBlock(list_pointer, index, &offset);
+    if (block->count == (int)UNROLLED_BLOCK_ITEMS) {
+        if (offset == 0 && (!block->prev || block->prev->count == (int)UNROLLED_BLOCK_ITEMS)) {
+            //inserting in front of a full block: start a new block before it instead of splitting
+            Block* newBlock = createBlock();
+            if (!newBlock) {
+                return 1;
+            }
+            linkAfter(list_pointer, block->prev, newBlock);
+            newBlock->items[newBlock->count++] = item;
+            list_pointer->length++;
+            return 0;
+        }
+        if (offset == 0) {
+            //room at the end of the previous block
+            block = block->prev;
+            offset = block->count;
+        } else {
+            //split the full block in half and insert into whichever half holds offset
+            Block* newBlock = createBlock();
+            if (!newBlock) {
+                return 1;
+            }
+            int keep = block->count / 2;
+            newBlock->count = block->count - keep;
+            memcpy(newBlock->items, block->items + keep, newBlock->count * sizeof(void*));
+            block->count = keep;
+            linkAfter(list_pointer, block, newBlock);
+            if (offset > keep) {
+                offset -= keep;
+                block = newBlock;
+            }
+        }
+    }
+    memmove(block->items + offset + 1, block->items + offset, (block->count - offset) * sizeof(void*));
+    block->items[offset] = item;
+    block->count++;
+    list_pointer->length++;
+    return 0;
+}
+
+// Remove item from the end of list and return a reference to it
+void* unrolledRemoveTail(UnrolledList* list_pointer) {
+    if (list_pointer->tail == NULL) {
+        return NULL;
+    }
+    Block* tail = list_pointer->tail;
+    void* item = tail->items[--tail->count];
+    list_pointer->length--;
+    if (tail->count == 0) {
+        unlinkBlock(list_pointer, tail);
+    }
+    return item;
+}
+
+// Remove item from start of list and return a reference to it
+void* unrolledRemoveHead(UnrolledList* list_pointer) {
+    if (list_pointer->head == NULL) {
+        return NULL;
+    }
+    return unrolledRemoveAtIndex(list_pointer, 0);
+}
+
+// Remove item at a specified index and return a reference to it
+void* unrolledRemoveAtIndex(UnrolledList* list_pointer, int index) {
+    if (list_pointer == NULL || index < 0 || index >= list_pointer->length) {
+        return NULL;
+    }
+    int offset;
+    Block* block = findBlock(list_pointer, index, &offset);
+    void* item = block->items[offset];
+    block->count--;
+    memmove(block->items + offset, block->items + offset + 1, (block->count - offset) * sizeof(void*));
+    list_pointer->length--;
+
+    if (block->count == 0) {
+        unlinkBlock(list_pointer, block);
+    } else if (block->next && block->count + block->next->count <= (int)UNROLLED_BLOCK_ITEMS / 2) {
+        //merge sparse neighbours so blocks stay at least a quarter full on average
+        Block* next = block->next;
+        memcpy(block->items + block->count, next->items, next->count * sizeof(void*));
+        block->count += next->count;
+        unlinkBlock(list_pointer, next);
+    }
+    return item;
+}
+
+// Return item at index
+void* unrolledItemAtIndex(UnrolledList* list_pointer, int index) {
+    if (list_pointer == NULL || index < 0 || index >= list_pointer->length) {
+        return NULL;
+    }
+    int offset;
+    Block* block = findBlock(list_pointer, index, &offset);
+    return block->items[offset];
+}
+
+// Return true if the list contains the given item at least once, false otherwise.
+bool unrolledContains(UnrolledList* list_pointer, void* item) {
+    if (list_pointer == NULL) {
+        return false;
+    }
+    for (Block* block = list_pointer->head; block != NULL; block = block->next) {
+        //items in a block are contiguous, so this inner loop is a linear array scan
+        for (int i = 0; i < block->count; i++) {
+            if (block->items[i] == item) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Returns the size of the list, measured in items.
+int unrolledSize(UnrolledList* list_pointer) {
+    if (list_pointer == NULL) {
+        return 0;
+    }
+    return list_pointer->length;
+}
+
+// Free every block; the list is empty afterwards
+void freeUnrolledList(UnrolledList* list_pointer) {
+    Block* current = list_pointer->head;
+    while (current != NULL) {
+        Block* next = current->next;
+        free(current);
+        current = next;
+    }
+    initUnrolledList(list_pointer);
+}
+
+void printUnrolledList(UnrolledList* list) {
+    // Handle an empty list. Just print a message.
+    if (list->head == NULL) {
+        printf("\nEmpty List");
+        return;
+    }
+
+    printf("\nList: \n\n\t");
+    for (Block* block = list->head; block != NULL; block = block->next) {
+        printf("{");
+        for (int i = 0; i < block->count; i++) {
+            printf("[ %p ]", block->items[i]);
+        }
+        printf("}");
+        if (block->next != NULL) {
+            printf("-->");
+        }
+    }
+    printf("\n\n");
+}
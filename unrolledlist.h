@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Unrolled linked list: same operations as List in linkedlist.h, but each
+// node ("block") holds up to UNROLLED_BLOCK_ITEMS items in an array, so walking
+// the list touches one block per UNROLLED_BLOCK_ITEMS items instead of one
+// node per item. Blocks are cache-line aligned and sized to whole cache lines.
+
+#define UNROLLED_BLOCK_BYTES 256
+#define UNROLLED_CACHE_LINE 64
+// Whatever is left of the block after the header holds items
+#define UNROLLED_BLOCK_ITEMS ((UNROLLED_BLOCK_BYTES - 2 * sizeof(void*) - sizeof(int) - sizeof(int)) / sizeof(void*))
+
+typedef struct Block{
+	struct Block* next;
+	struct Block* prev;
+	int count;   // Items in use, at items[0..count)
+	int unused;  // Keeps items pointer-aligned on every ABI
+	void* items[UNROLLED_BLOCK_ITEMS];
+}Block;
+
+typedef struct {
+	Block* head;
+	Block* tail;
+	int length;  // Total items, kept up to date so size() is O(1)
+}UnrolledList;
+
+// Initialize an empty list
+void initUnrolledList(UnrolledList* list_pointer);
+
+// Insert new item at the end of list.
+int unrolledInsertAtTail(UnrolledList* list_pointer, void* item);
+
+// Insert item at start of the list.
+int unrolledInsertAtHead(UnrolledList* list_pointer, void* item);
+
+// Insert item at a specified index.
+int unrolledInsertAtIndex(UnrolledList* list_pointer, int index, void* item);
+
+// Remove item from the end of list and return a reference to it
+void* unrolledRemoveTail(UnrolledList* list_pointer);
+
+// Remove item from start of list and return a reference to it
+void* unrolledRemoveHead(UnrolledList* list_pointer);
+
+// Remove item at a specified index and return a reference to it
+void* unrolledRemoveAtIndex(UnrolledList* list_pointer, int index);
+
+// Return item at index
+void* unrolledItemAtIndex(UnrolledList* list_pointer, int index);
+
+// Return true if the list contains the given item at least once, false otherwise.
+bool unrolledContains(UnrolledList* list_pointer, void* item);
+
+// Returns the size of the list, measured in items.
+int unrolledSize(UnrolledList* list_pointer);
+
+// Print List
+void printUnrolledList(UnrolledList* list_pointer);
+
+// Free every block; the list is empty afterwards
+void freeUnrolledList(UnrolledList* list_pointer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Key streams for benchmarking the hash set under something other than the
+// sequential 1..N best case, plus replay of recorded traces.
+
+// One decoded bytecode instruction, in the format described at the top of tests
+struct Instruction {
+    char code;   // H, I, R, C, D, S, L or X
+    int value;   // Operand; 0 for X
+};
+
+// Decode bytecode text in a single pass. Lines starting with "--" are comments;
+// whitespace between instructions is ignored.
+inline std::vector<Instruction> parseBytecode(const char* text, size_t length) {
+    std::vector<Instruction> program;
+    size_t i = 0;
+    while (i < length) {
+        char c = text[i];
+        if (c == '-' && i + 1 < length && text[i + 1] == '-') {
+            while (i < length && text[i] != '\n') i++;  // Skip the comment line
+            continue;
+        }
+        if (c < 'A' || c > 'Z') {
+            i++;
+            continue;
+        }
+        i++;
+        bool negative = i < length && text[i] == '-';
+        if (negative) i++;
+        int value = 0;
+        while (i < length && text[i] >= '0' && text[i] <= '9') {
+            value = value * 10 + (text[i] - '0');
+            i++;
+        }
+        program.push_back({c, negative ? -value : value});
+    }
+    return program;
+}
+
+enum class OpType : uint8_t { Insert, Lookup, Remove };
+
+struct WorkloadOp {
+    OpType type;
+    int key;
+};
+
+// Keys inserted before timing starts, and the timed operation stream
+struct Workload {
+    std::vector<int> preload;
+    std::vector<WorkloadOp> ops;
+};
+
+struct WorkloadConfig {
+    // sequential, uniform, zipf, collide or negative
+    std::string distribution = "uniform";
+    size_t keys = 100000;          // Size of the key universe
+    size_t ops = 1000000;          // Timed operations to generate
+    unsigned int insert_pct = 10;  // Operation mix; the three add up to 100
+    unsigned int lookup_pct = 80;
+    unsigned int remove_pct = 10;
+    double zipf_exponent = 0.99;
+    size_t collide_stride = 1024;  // Keys are multiples of this for "collide"
+    unsigned int negative_pct = 90; // Share of lookups that miss for "negative"
+    uint64_t seed = 42;
+};
+
+// Parse an "insert:lookup:remove" percentage mix such as "10:80:10"
+inline void parseMix(const std::string& mix, WorkloadConfig& config) {
+    unsigned int parts[3];
+    std::istringstream iss(mix);
+    char sep1 = 0, sep2 = 0;
+    if (!(iss >> parts[0] >> sep1 >> parts[1] >> sep2 >> parts[2]) || sep1 != ':' || sep2 != ':' ||
+        parts[0] + parts[1] + parts[2] != 100) {
+        throw std::invalid_argument("Mix must be insert:lookup:remove percentages adding up to 100");
+    }
+    config.insert_pct = parts[0];
+    config.lookup_pct = parts[1];
+    config.remove_pct = parts[2];
+}
+
+// Parameters that determine a generated workload, as one comma-free token list
+// such as "uniform mix=10:80:10 keys=100000 ops=1000000 seed=42"
+inline std::string describeWorkload(const WorkloadConfig& config) {
+    std::ostringstream out;
+    out << config.distribution << " mix=" << config.insert_pct << ":" << config.lookup_pct << ":"
+        << config.remove_pct << " keys=" << config.keys << " ops=" << config.ops << " seed=" << config.seed;
+    if (config.distribution == "zipf") out << " zipf=" << config.zipf_exponent;
+    if (config.distribution == "collide") out << " stride=" << config.collide_stride;
+    if (config.distribution == "negative") out << " negative=" << config.negative_pct;
+    return out.str();
+}
+
+// Draws ranks 0..n-1 with P(rank k) proportional to 1 / (k + 1)^s
+class ZipfGenerator {
+private:
+    std::vector<double> cdf;
+
+public:
+    ZipfGenerator(size_t n, double s) : cdf(n) {
+        double sum = 0;
+        for (size_t k = 0; k < n; k++) {
+            sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+            cdf[k] = sum;
+        }
+        for (double& p : cdf) p /= sum;
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+    }
+};
+
+// Map the i-th key of the universe to an int key for the chosen distribution
+inline int universeKey(const WorkloadConfig& config, size_t i) {
+    if (config.distribution == "sequential") {
+        return static_cast<int>(i + 1);
+    }
+    if (config.distribution == "collide") {
+        // Multiples of the stride all hash to bucket 0 while the bucket
+        // count divides the stride
+        return static_cast<int>((i + 1) * config.collide_stride);
+    }
+    // Scatter so hot zipf ranks aren't neighbours; odd multipliers are
+    // bijective mod 2^32, and the top bit is dropped to keep keys positive
+    return static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) >> 1);
+}
+
+// Whether every "collide" key, up to keys * stride, fits in an int
+inline bool collideKeysFit(size_t keys, size_t stride) {
+    return stride > 0 && keys + 1 <= 0x7fffffffUL / stride;
+}
+
+// Stride that makes every "collide" key land in bucket 0 of a HashSet that
+// starts with initial_buckets buckets and doubles up to 8 times, as large as
+// fits without overflowing int keys. Throws if even initial_buckets doesn't fit.
+inline size_t collisionStride(size_t keys, size_t initial_buckets) {
+    size_t stride = std::max<size_t>(1, initial_buckets);
+    if (!collideKeysFit(keys, stride)) {
+        throw std::invalid_argument("Too many keys for collide: " + std::to_string(keys) + " keys x stride " +
+                                    std::to_string(stride) + " overflows int");
+    }
+    for (int doublings = 0; doublings < 8 && collideKeysFit(keys, stride * 2); doublings++) {
+        stride *= 2;
+    }
+    return stride;
+}
+
+// Generate the preload set and operation stream for config
+inline Workload generateWorkload(const WorkloadConfig& config) {
+    if (config.keys == 0) throw std::invalid_argument("Workload needs at least one key");
+    if (config.distribution != "sequential" && config.distribution != "uniform" &&
+        config.distribution != "zipf" && config.distribution != "collide" &&
+        config.distribution != "negative") {
+        throw std::invalid_argument("Unknown distribution: " + config.distribution);
+    }
+    if (config.distribution == "collide" && !collideKeysFit(config.keys, config.collide_stride)) {
+        throw std::invalid_argument("Too many keys for collide: keys x stride overflows int");
+    }
+
+    Workload workload;
+    std::mt19937_64 rng(config.seed);
+
+    // Half the universe is present before timing, so lookups hit and miss
+    workload.preload.reserve(config.keys / 2);
+    for (size_t i = 0; i < config.keys; i += 2) {
+        workload.preload.push_back(universeKey(config, i));
+    }
+
+    bool zipf = config.distribution == "zipf";
+    ZipfGenerator zipf_ranks(zipf ? config.keys : 1, config.zipf_exponent);
+    std::uniform_int_distribution<size_t> uniform_index(0, config.keys - 1);
+    std::uniform_int_distribution<unsigned int> percent(0, 99);
+
+    workload.ops.reserve(config.ops);
+    for (size_t n = 0; n < config.ops; n++) {
+        unsigned int roll = percent(rng);
+        OpType type = roll < config.insert_pct ? OpType::Insert
+                    : roll < config.insert_pct + config.lookup_pct ? OpType::Lookup
+                    : OpType::Remove;
+        size_t index = zipf ? zipf_ranks(rng) : uniform_index(rng);
+        int key = universeKey(config, index);
+        if (config.distribution == "negative" && type == OpType::Lookup &&
+            percent(rng) < config.negative_pct) {
+            key = -key - 1;  // Universe keys are positive, so this always misses
+        }
+        workload.ops.push_back({type, key});
+    }
+    return workload;
+}
+
+// Load a recorded trace in the tests bytecode format. I becomes an insert,
+// C and D lookups, R a remove; H, S, L and X are ignored.
+inline Workload loadTrace(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to open trace: " + path);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Workload workload;
+    for (const Instruction& ins : parseBytecode(text.data(), text.size())) {
+        switch (ins.code) {
+            case 'I': workload.ops.push_back({OpType::Insert, ins.value}); break;
+            case 'C': case 'D': workload.ops.push_back({OpType::Lookup, ins.value}); break;
+            case 'R': workload.ops.push_back({OpType::Remove, ins.value}); break;
+            default: break;
+        }
+    }
+    return workload;
+}
+
+#endif // WORKLOAD_HPP